@@ -0,0 +1,176 @@
+#include "BenchmarkReport.h"
+#include "Scenarios.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+
+static void PrintUsage(const char* program)
+{
+	std::cerr << "Usage: " << program << " [options]\n"
+		<< "  --scenario <name>     trigger_soup, bouncing_collision, ground_stacking, star_system or all (default: all)\n"
+		<< "  --bodies <n[,n...]>   body counts to run each scenario at (default: 300,1000,5000)\n"
+		<< "  --frames <n>          measured frames (default: 600)\n"
+		<< "  --warmup <n>          frames simulated before measuring (default: 60)\n"
+		<< "  --dt <seconds>        fixed time step (default: 0.016667)\n"
+		<< "  --seed <n>            seed of the scenario spawns (default: 42)\n"
+		<< "  --sleeping <on|off>   let the resting bodies fall asleep (default: off)\n"
+		<< "  --loose <on|off>      store each collider once in a loose QuadTree (default: off)\n"
+		<< "  --tune <on|off>       tune the QuadTree limits to the fewest pair tests (default: off)\n"
+		<< "  --output <file>       write the JSON report to a file instead of the standard output\n";
+}
+
+[[nodiscard]] static std::vector<std::unique_ptr<Scenario>> CreateScenarios(const std::string& name)
+{
+	std::vector<std::unique_ptr<Scenario>> scenarios;
+	scenarios.push_back(std::make_unique<TriggerSoupScenario>());
+	scenarios.push_back(std::make_unique<BouncingCollisionScenario>());
+	scenarios.push_back(std::make_unique<GroundStackingScenario>());
+	scenarios.push_back(std::make_unique<StarSystemScenario>());
+
+	if (name == "all")
+	{
+		return scenarios;
+	}
+
+	std::vector<std::unique_ptr<Scenario>> selected;
+	for (auto& scenario : scenarios)
+	{
+		if (scenario->GetName() == name)
+		{
+			selected.push_back(std::move(scenario));
+		}
+	}
+	return selected;
+}
+
+int main(int argc, char* argv[])
+{
+	BenchmarkSettings settings;
+	std::string scenarioName = "all";
+	std::vector<std::size_t> bodyCounts = { 300, 1000, 5000 };
+	std::string outputPath;
+
+	try
+	{
+		for (int i = 1; i < argc; ++i)
+		{
+			const std::string arg = argv[i];
+			if (arg == "--help" || arg == "-h")
+			{
+				PrintUsage(argv[0]);
+				return EXIT_SUCCESS;
+			}
+			if (i + 1 >= argc)
+			{
+				throw std::invalid_argument("Missing value for " + arg);
+			}
+
+			const std::string value = argv[++i];
+			if (arg == "--scenario")
+			{
+				scenarioName = value;
+			}
+			else if (arg == "--bodies")
+			{
+				bodyCounts.clear();
+				std::stringstream stream(value);
+				std::string count;
+				while (std::getline(stream, count, ','))
+				{
+					bodyCounts.push_back(std::stoul(count));
+				}
+			}
+			else if (arg == "--frames")
+			{
+				settings.FrameCount = std::stoul(value);
+			}
+			else if (arg == "--warmup")
+			{
+				settings.WarmUpFrameCount = std::stoul(value);
+			}
+			else if (arg == "--dt")
+			{
+				settings.DeltaTime = std::stof(value);
+			}
+			else if (arg == "--seed")
+			{
+				settings.Seed = static_cast<unsigned int>(std::stoul(value));
+			}
+			else if (arg == "--sleeping")
+			{
+				if (value != "on" && value != "off")
+				{
+					throw std::invalid_argument("--sleeping expects on or off");
+				}
+				settings.IsSleepingEnabled = value == "on";
+			}
+			else if (arg == "--loose")
+			{
+				if (value != "on" && value != "off")
+				{
+					throw std::invalid_argument("--loose expects on or off");
+				}
+				settings.IsLooseQuadTree = value == "on";
+			}
+			else if (arg == "--tune")
+			{
+				if (value != "on" && value != "off")
+				{
+					throw std::invalid_argument("--tune expects on or off");
+				}
+				settings.IsQuadTreeTuned = value == "on";
+			}
+			else if (arg == "--output")
+			{
+				outputPath = value;
+			}
+			else
+			{
+				throw std::invalid_argument("Unknown option " + arg);
+			}
+		}
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << e.what() << "\n";
+		PrintUsage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	auto scenarios = CreateScenarios(scenarioName);
+	if (scenarios.empty())
+	{
+		std::cerr << "Unknown scenario " << scenarioName << "\n";
+		PrintUsage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	std::vector<ScenarioResult> results;
+	for (auto& scenario : scenarios)
+	{
+		for (const auto bodyCount : bodyCounts)
+		{
+			std::cerr << "Running " << scenario->GetName() << " with " << bodyCount << " bodies\n";
+			results.push_back(RunScenario(*scenario, bodyCount, settings));
+		}
+	}
+
+	if (outputPath.empty())
+	{
+		WriteJson(std::cout, settings, results);
+		return EXIT_SUCCESS;
+	}
+
+	std::ofstream file(outputPath);
+	if (!file)
+	{
+		std::cerr << "Cannot open " << outputPath << "\n";
+		return EXIT_FAILURE;
+	}
+	WriteJson(file, settings, results);
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,213 @@
+#include "Recorder.h"
+#include "Replayer.h"
+#include "Scenarios.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+
+static void PrintUsage(const char* program)
+{
+	std::cerr << "Usage: " << program << " <command> <file> [options]\n"
+		<< "  record <file>         record a benchmark scenario\n"
+		<< "    --scenario <name>   trigger_soup, bouncing_collision, ground_stacking or star_system (default: bouncing_collision)\n"
+		<< "    --bodies <n>        body count (default: 1000)\n"
+		<< "    --frames <n>        recorded frames (default: 600)\n"
+		<< "    --keyframes <n>     frames between two keyframes (default: 120)\n"
+		<< "    --seed <n>          seed of the scenario spawns (default: 42)\n"
+		<< "  info <file>           print the frame and keyframe counts of a replay file\n"
+		<< "  seek <file> <frame>   restore a frame and print its timing and state hash\n"
+		<< "  verify <file>         replay every frame, checking the state hash of the keyframes\n";
+}
+
+[[nodiscard]] static std::unique_ptr<Scenario> CreateScenario(const std::string& name)
+{
+	if (name == "trigger_soup")
+	{
+		return std::make_unique<TriggerSoupScenario>();
+	}
+	if (name == "bouncing_collision")
+	{
+		return std::make_unique<BouncingCollisionScenario>();
+	}
+	if (name == "ground_stacking")
+	{
+		return std::make_unique<GroundStackingScenario>();
+	}
+	if (name == "star_system")
+	{
+		return std::make_unique<StarSystemScenario>();
+	}
+	throw std::invalid_argument("Unknown scenario " + name);
+}
+
+static int Record(const std::string& path, int argc, char* argv[], int first)
+{
+	std::string scenarioName = "bouncing_collision";
+	ScenarioConfig config;
+	config.BodyCount = 1000;
+	std::size_t frameCount = 600;
+	std::uint32_t keyframeInterval = Recorder::DEFAULT_KEYFRAME_INTERVAL;
+
+	for (int i = first; i < argc; ++i)
+	{
+		const std::string arg = argv[i];
+		if (i + 1 >= argc)
+		{
+			throw std::invalid_argument("Missing value for " + arg);
+		}
+
+		const std::string value = argv[++i];
+		if (arg == "--scenario")
+		{
+			scenarioName = value;
+		}
+		else if (arg == "--bodies")
+		{
+			config.BodyCount = std::stoul(value);
+		}
+		else if (arg == "--frames")
+		{
+			frameCount = std::stoul(value);
+		}
+		else if (arg == "--keyframes")
+		{
+			keyframeInterval = static_cast<std::uint32_t>(std::stoul(value));
+		}
+		else if (arg == "--seed")
+		{
+			config.Seed = static_cast<unsigned int>(std::stoul(value));
+		}
+		else
+		{
+			throw std::invalid_argument("Unknown option " + arg);
+		}
+	}
+
+	auto scenario = CreateScenario(scenarioName);
+	scenario->SetUp(config);
+
+	Recorder recorder;
+	recorder.Open(path, keyframeInterval);
+	scenario->GetWorld().SetUpdateListener(&recorder);
+
+	const auto start = std::chrono::high_resolution_clock::now();
+	for (std::size_t frame = 0; frame < frameCount; ++frame)
+	{
+		scenario->Update(1.f / 60.f);
+	}
+	const double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+	scenario->GetWorld().SetUpdateListener(nullptr);
+	recorder.Close();
+	scenario->TearDown();
+
+	std::cout << "Recorded " << frameCount << " frames of " << scenarioName << " in " << elapsedMs << " ms\n";
+	return EXIT_SUCCESS;
+}
+
+static int Info(const std::string& path)
+{
+	Replayer replayer;
+	replayer.Open(path);
+
+	const auto frameCount = replayer.GetFrameCount();
+	std::cout << "{\n"
+		<< "  \"frames\": " << frameCount << ",\n"
+		<< "  \"keyframes\": " << replayer.GetKeyframes().size() << ",\n"
+		<< "  \"keyframe_interval\": " << replayer.GetKeyframeInterval() << ",\n"
+		<< "  \"file_bytes\": " << replayer.GetFileSize() << ",\n"
+		<< "  \"bytes_per_frame\": " << (frameCount > 0 ? replayer.GetFileSize() / frameCount : 0) << "\n"
+		<< "}\n";
+	return EXIT_SUCCESS;
+}
+
+static int Seek(const std::string& path, const std::uint64_t frame)
+{
+	Replayer replayer;
+	replayer.Open(path);
+
+	World world;
+	const auto start = std::chrono::high_resolution_clock::now();
+	replayer.Seek(world, frame);
+	const double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+	std::cout << "{\n"
+		<< "  \"frame\": " << frame << ",\n"
+		<< "  \"keyframe\": " << (replayer.IsKeyframe() ? "true" : "false") << ",\n"
+		<< "  \"seek_ms\": " << elapsedMs << ",\n"
+		<< "  \"recorded_hash\": \"" << std::hex << replayer.GetRecordedStateHash() << "\",\n"
+		<< "  \"restored_hash\": \"" << world.StateHash() << std::dec << "\"\n"
+		<< "}\n";
+	return EXIT_SUCCESS;
+}
+
+static int Verify(const std::string& path)
+{
+	Replayer replayer;
+	replayer.Open(path);
+
+	// Only the keyframes restore the exact state, the delta frames are quantized
+	World world;
+	std::size_t keyframeCount = 0;
+	std::size_t mismatchCount = 0;
+	while (replayer.Next(world))
+	{
+		if (!replayer.IsKeyframe())
+		{
+			continue;
+		}
+		keyframeCount++;
+		if (world.StateHash() != replayer.GetRecordedStateHash())
+		{
+			std::cerr << "State hash mismatch at keyframe " << replayer.GetFrame() << "\n";
+			mismatchCount++;
+		}
+	}
+
+	std::cout << "Replayed " << replayer.GetFrameCount() << " frames, " << keyframeCount << " keyframes, "
+		<< mismatchCount << " mismatches\n";
+	return mismatchCount == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc < 3)
+	{
+		PrintUsage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	const std::string command = argv[1];
+	const std::string path = argv[2];
+
+	try
+	{
+		if (command == "record")
+		{
+			return Record(path, argc, argv, 3);
+		}
+		if (command == "info")
+		{
+			return Info(path);
+		}
+		if (command == "seek" && argc == 4)
+		{
+			return Seek(path, std::stoull(argv[3]));
+		}
+		if (command == "verify")
+		{
+			return Verify(path);
+		}
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << e.what() << "\n";
+		return EXIT_FAILURE;
+	}
+
+	PrintUsage(argv[0]);
+	return EXIT_FAILURE;
+}
@@ -0,0 +1,520 @@
+#include "Collider.h"
+#include "Shape.h"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Count every heap allocation of the process, the intersect routines must be measured allocation included
+// Every replaceable form is replaced, so that no array, nothrow or aligned allocation escapes the count
+static std::atomic<std::size_t> AllocationCount{ 0 };
+
+[[nodiscard]] static void* CountedAllocate(const std::size_t size) noexcept
+{
+	AllocationCount.fetch_add(1, std::memory_order_relaxed);
+	return std::malloc(size == 0 ? 1 : size);
+}
+
+// The block returned by malloc is stored just before the aligned address, to be freed from it
+[[nodiscard]] static void* CountedAllocate(const std::size_t size, const std::align_val_t alignment) noexcept
+{
+	AllocationCount.fetch_add(1, std::memory_order_relaxed);
+	const auto align = static_cast<std::size_t>(alignment);
+	void* block = std::malloc(size + align + sizeof(void*));
+	if (block == nullptr)
+	{
+		return nullptr;
+	}
+
+	const auto address = (reinterpret_cast<std::uintptr_t>(block) + sizeof(void*) + align - 1) & ~(align - 1);
+	reinterpret_cast<void**>(address)[-1] = block;
+	return reinterpret_cast<void*>(address);
+}
+
+static void CountedFree(void* ptr, const std::align_val_t) noexcept
+{
+	if (ptr != nullptr)
+	{
+		std::free(static_cast<void**>(ptr)[-1]);
+	}
+}
+
+void* operator new(std::size_t size)
+{
+	if (void* ptr = CountedAllocate(size))
+	{
+		return ptr;
+	}
+	throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+	return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+	return CountedAllocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+	return CountedAllocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+	if (void* ptr = CountedAllocate(size, alignment))
+	{
+		return ptr;
+	}
+	throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+	return operator new(size, alignment);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	return CountedAllocate(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	return CountedAllocate(size, alignment);
+}
+
+void operator delete(void* ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t alignment) noexcept
+{
+	CountedFree(ptr, alignment);
+}
+
+void operator delete[](void* ptr, std::align_val_t alignment) noexcept
+{
+	CountedFree(ptr, alignment);
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t alignment) noexcept
+{
+	CountedFree(ptr, alignment);
+}
+
+void operator delete[](void* ptr, std::size_t, std::align_val_t alignment) noexcept
+{
+	CountedFree(ptr, alignment);
+}
+
+void operator delete(void* ptr, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	CountedFree(ptr, alignment);
+}
+
+void operator delete[](void* ptr, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	CountedFree(ptr, alignment);
+}
+
+/**
+ * @brief Measure of one shape pair routine.
+ */
+struct MicroResult
+{
+	std::string Name;
+	int VerticesA = 0; /**< Vertex count of the first shape, 0 if it is not a polygon. */
+	int VerticesB = 0; /**< Vertex count of the second shape, 0 if it is not a polygon. */
+	float HitRatio = -1.f; /**< Requested ratio of overlapping pairs, negative if it does not apply. */
+	float MeasuredHitRatio = -1.f; /**< Ratio of pairs the routine reported as overlapping. */
+	double NsPerTest = 0.0;
+	double AllocationsPerTest = 0.0;
+};
+
+static constexpr float SHAPE_RADIUS = 1.f;
+static constexpr std::size_t PAIR_NBR = 1024;
+
+static std::mt19937 RandomGenerator(42);
+
+[[nodiscard]] static float Range(const float min, const float max)
+{
+	std::uniform_real_distribution<float> dis(min, max);
+	return dis(RandomGenerator);
+}
+
+[[nodiscard]] static CircleF MakeShape(const XMVECTOR center, const CircleF*, int)
+{
+	return CircleF(center, SHAPE_RADIUS);
+}
+
+[[nodiscard]] static RectangleF MakeShape(const XMVECTOR center, const RectangleF*, int)
+{
+	return RectangleF::FromCenter(center, XMVectorSet(SHAPE_RADIUS, SHAPE_RADIUS, 0, 0));
+}
+
+// Regular polygon with a random orientation, its inscribed circle is never smaller than half the radius
+[[nodiscard]] static PolygonF MakeShape(const XMVECTOR center, const PolygonF*, const int vertexCount)
+{
+	std::vector<XMVECTOR> vertices;
+	vertices.reserve(vertexCount);
+	const float rotation = Range(0.f, XM_2PI);
+	for (int i = 0; i < vertexCount; ++i)
+	{
+		const float angle = rotation + XM_2PI * static_cast<float>(i) / static_cast<float>(vertexCount);
+		vertices.push_back(XMVectorAdd(center, XMVectorSet(std::cos(angle) * SHAPE_RADIUS, std::sin(angle) * SHAPE_RADIUS, 0, 0)));
+	}
+	return PolygonF(vertices);
+}
+
+// Oblong rectangle with a random rotation, the same inscribed circle bound as the polygons
+[[nodiscard]] static OrientedRectangleF MakeShape(const XMVECTOR center, const OrientedRectangleF*, int)
+{
+	return OrientedRectangleF(center, XMVectorSet(0.8f * SHAPE_RADIUS, 0.5f * SHAPE_RADIUS, 0, 0), Range(0.f, XM_2PI));
+}
+
+/**
+ * @brief Generate shape pairs of which the requested ratio overlap.
+ * @note Overlapping pairs have the center of the second shape inside the first one,
+ * the others are further apart than the sum of their bounding circles.
+ */
+template <typename ShapeA, typename ShapeB>
+[[nodiscard]] static std::vector<std::pair<ShapeA, ShapeB>> MakePairs(const float hitRatio, const int verticesA, const int verticesB)
+{
+	std::vector<std::pair<ShapeA, ShapeB>> pairs;
+	pairs.reserve(PAIR_NBR);
+
+	const auto hitNbr = static_cast<std::size_t>(hitRatio * PAIR_NBR);
+	for (std::size_t i = 0; i < PAIR_NBR; ++i)
+	{
+		const XMVECTOR centerA = XMVectorSet(Range(-100.f, 100.f), Range(-100.f, 100.f), 0, 0);
+		const float angle = Range(0.f, XM_2PI);
+		const float distance = i < hitNbr ? Range(0.f, 0.5f * SHAPE_RADIUS) : Range(3.f * SHAPE_RADIUS, 4.f * SHAPE_RADIUS);
+		const XMVECTOR centerB = XMVectorAdd(centerA, XMVectorSet(std::cos(angle) * distance, std::sin(angle) * distance, 0, 0));
+
+		pairs.emplace_back(MakeShape(centerA, static_cast<const ShapeA*>(nullptr), verticesA),
+			MakeShape(centerB, static_cast<const ShapeB*>(nullptr), verticesB));
+	}
+
+	// Mix hits and misses so that the branch predictor cannot learn the sequence
+	std::shuffle(pairs.begin(), pairs.end(), RandomGenerator);
+	return pairs;
+}
+
+/**
+ * @brief Shapes of two colliders with the positions of their bodies, as the narrowphase meets them.
+ */
+struct PlacedPair
+{
+	ColliderShape ShapeA;
+	XMVECTOR PositionA;
+	ColliderShape ShapeB;
+	XMVECTOR PositionB;
+};
+
+/**
+ * @brief Generate placed pairs of which the requested ratio overlap, the shapes are built around the origin.
+ */
+template <typename ShapeA, typename ShapeB>
+[[nodiscard]] static std::vector<PlacedPair> MakePlacedPairs(const float hitRatio, const int verticesA, const int verticesB)
+{
+	std::vector<PlacedPair> pairs;
+	pairs.reserve(PAIR_NBR);
+
+	const auto hitNbr = static_cast<std::size_t>(hitRatio * PAIR_NBR);
+	for (std::size_t i = 0; i < PAIR_NBR; ++i)
+	{
+		const XMVECTOR positionA = XMVectorSet(Range(-100.f, 100.f), Range(-100.f, 100.f), 0, 0);
+		const float angle = Range(0.f, XM_2PI);
+		const float distance = i < hitNbr ? Range(0.f, 0.5f * SHAPE_RADIUS) : Range(3.f * SHAPE_RADIUS, 4.f * SHAPE_RADIUS);
+		const XMVECTOR positionB = XMVectorAdd(positionA, XMVectorSet(std::cos(angle) * distance, std::sin(angle) * distance, 0, 0));
+
+		pairs.push_back({ MakeShape(XMVectorZero(), static_cast<const ShapeA*>(nullptr), verticesA), positionA,
+			MakeShape(XMVectorZero(), static_cast<const ShapeB*>(nullptr), verticesB), positionB });
+	}
+
+	std::shuffle(pairs.begin(), pairs.end(), RandomGenerator);
+	return pairs;
+}
+
+template <typename ShapeA, typename ShapeB>
+[[nodiscard]] static MicroResult MeasureIntersect(const std::string& name, const float hitRatio,
+	const int verticesA, const int verticesB, const std::size_t testNbr)
+{
+	const auto pairs = MakePairs<ShapeA, ShapeB>(hitRatio, verticesA, verticesB);
+	const std::size_t roundNbr = Max<std::size_t>(1, testNbr / pairs.size());
+
+	std::size_t hitNbr = 0;
+	const std::size_t allocationsBefore = AllocationCount.load(std::memory_order_relaxed);
+	const auto start = std::chrono::high_resolution_clock::now();
+
+	for (std::size_t round = 0; round < roundNbr; ++round)
+	{
+		for (const auto& [shapeA, shapeB] : pairs)
+		{
+			hitNbr += Intersect(shapeA, shapeB) ? 1 : 0;
+		}
+	}
+
+	const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now() - start).count();
+	const std::size_t allocations = AllocationCount.load(std::memory_order_relaxed) - allocationsBefore;
+	const auto totalTests = static_cast<double>(roundNbr * pairs.size());
+
+	MicroResult result;
+	result.Name = name;
+	result.VerticesA = verticesA;
+	result.VerticesB = verticesB;
+	result.HitRatio = hitRatio;
+	result.MeasuredHitRatio = static_cast<float>(static_cast<double>(hitNbr) / totalTests);
+	result.NsPerTest = elapsed / totalTests;
+	result.AllocationsPerTest = static_cast<double>(allocations) / totalTests;
+	return result;
+}
+
+/**
+ * @brief Measure the collider level overlap test, which places the shapes at their body positions on every call.
+ */
+template <typename ShapeA, typename ShapeB>
+[[nodiscard]] static MicroResult MeasureOverlap(const std::string& name, const float hitRatio,
+	const int verticesA, const int verticesB, const std::size_t testNbr)
+{
+	const auto pairs = MakePlacedPairs<ShapeA, ShapeB>(hitRatio, verticesA, verticesB);
+	const std::size_t roundNbr = Max<std::size_t>(1, testNbr / pairs.size());
+
+	std::size_t hitNbr = 0;
+	const std::size_t allocationsBefore = AllocationCount.load(std::memory_order_relaxed);
+	const auto start = std::chrono::high_resolution_clock::now();
+
+	for (std::size_t round = 0; round < roundNbr; ++round)
+	{
+		for (const auto& pair : pairs)
+		{
+			hitNbr += Overlap(pair.ShapeA, pair.PositionA, pair.ShapeB, pair.PositionB) ? 1 : 0;
+		}
+	}
+
+	const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now() - start).count();
+	const std::size_t allocations = AllocationCount.load(std::memory_order_relaxed) - allocationsBefore;
+	const auto totalTests = static_cast<double>(roundNbr * pairs.size());
+
+	MicroResult result;
+	result.Name = name;
+	result.VerticesA = verticesA;
+	result.VerticesB = verticesB;
+	result.HitRatio = hitRatio;
+	result.MeasuredHitRatio = static_cast<float>(static_cast<double>(hitNbr) / totalTests);
+	result.NsPerTest = elapsed / totalTests;
+	result.AllocationsPerTest = static_cast<double>(allocations) / totalTests;
+	return result;
+}
+
+[[nodiscard]] static MicroResult MeasureClosestPointOnSegment(const std::size_t testNbr)
+{
+	struct SegmentQuery
+	{
+		XMVECTOR A, B, P;
+	};
+	std::vector<SegmentQuery> queries;
+	queries.reserve(PAIR_NBR);
+	for (std::size_t i = 0; i < PAIR_NBR; ++i)
+	{
+		queries.push_back({
+			XMVectorSet(Range(-1.f, 1.f), Range(-1.f, 1.f), 0, 0),
+			XMVectorSet(Range(-1.f, 1.f), Range(-1.f, 1.f), 0, 0),
+			XMVectorSet(Range(-2.f, 2.f), Range(-2.f, 2.f), 0, 0) });
+	}
+	const std::size_t roundNbr = Max<std::size_t>(1, testNbr / queries.size());
+
+	XMVECTOR sum = XMVectorZero();
+	const std::size_t allocationsBefore = AllocationCount.load(std::memory_order_relaxed);
+	const auto start = std::chrono::high_resolution_clock::now();
+
+	for (std::size_t round = 0; round < roundNbr; ++round)
+	{
+		for (const auto& query : queries)
+		{
+			sum = XMVectorAdd(sum, ClosestPointOnSegment(query.A, query.B, query.P));
+		}
+	}
+
+	const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now() - start).count();
+	const std::size_t allocations = AllocationCount.load(std::memory_order_relaxed) - allocationsBefore;
+	const auto totalTests = static_cast<double>(roundNbr * queries.size());
+
+	// Keep the result alive so that the loop is not optimized away
+	volatile float sink = XMVectorGetX(sum);
+	(void)sink;
+
+	MicroResult result;
+	result.Name = "closest_point_on_segment";
+	result.NsPerTest = elapsed / totalTests;
+	result.AllocationsPerTest = static_cast<double>(allocations) / totalTests;
+	return result;
+}
+
+static void WriteJson(std::ostream& out, const std::size_t testNbr, const std::vector<MicroResult>& results)
+{
+	out << "{\n";
+	out << "  \"tests_per_case\": " << testNbr << ",\n";
+	out << "  \"results\": [\n";
+	for (std::size_t i = 0; i < results.size(); ++i)
+	{
+		const auto& result = results[i];
+		out << "    {\"routine\": \"" << result.Name << "\"";
+		out << ", \"vertices_a\": " << result.VerticesA;
+		out << ", \"vertices_b\": " << result.VerticesB;
+		if (result.HitRatio >= 0.f)
+		{
+			out << ", \"hit_ratio\": " << result.HitRatio;
+			out << ", \"measured_hit_ratio\": " << result.MeasuredHitRatio;
+		}
+		out << ", \"ns_per_test\": " << result.NsPerTest;
+		out << ", \"allocations_per_test\": " << result.AllocationsPerTest << "}";
+		out << (i + 1 < results.size() ? ",\n" : "\n");
+	}
+	out << "  ]\n";
+	out << "}\n";
+}
+
+static void PrintUsage(const char* program)
+{
+	std::cerr << "Usage: " << program << " [options]\n"
+		<< "  --tests <n>             intersection tests per case (default: 200000)\n"
+		<< "  --hit-ratios <r[,r...]> ratios of overlapping pairs (default: 0,0.5,1)\n"
+		<< "  --output <file>         write the JSON report to a file instead of the standard output\n";
+}
+
+int main(int argc, char* argv[])
+{
+	std::size_t testNbr = 200000;
+	std::vector<float> hitRatios = { 0.f, 0.5f, 1.f };
+	std::string outputPath;
+
+	try
+	{
+		for (int i = 1; i < argc; ++i)
+		{
+			const std::string arg = argv[i];
+			if (arg == "--help" || arg == "-h")
+			{
+				PrintUsage(argv[0]);
+				return EXIT_SUCCESS;
+			}
+			if (i + 1 >= argc)
+			{
+				throw std::invalid_argument("Missing value for " + arg);
+			}
+
+			const std::string value = argv[++i];
+			if (arg == "--tests")
+			{
+				testNbr = std::stoul(value);
+			}
+			else if (arg == "--hit-ratios")
+			{
+				hitRatios.clear();
+				std::stringstream stream(value);
+				std::string ratio;
+				while (std::getline(stream, ratio, ','))
+				{
+					hitRatios.push_back(Clamp(std::stof(ratio), 0.f, 1.f));
+				}
+			}
+			else if (arg == "--output")
+			{
+				outputPath = value;
+			}
+			else
+			{
+				throw std::invalid_argument("Unknown option " + arg);
+			}
+		}
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << e.what() << "\n";
+		PrintUsage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	static constexpr int MIN_VERTICES = 3;
+	static constexpr int MAX_VERTICES = 16;
+
+	std::vector<MicroResult> results;
+	for (const float hitRatio : hitRatios)
+	{
+		results.push_back(MeasureIntersect<CircleF, CircleF>("circle_circle", hitRatio, 0, 0, testNbr));
+		results.push_back(MeasureIntersect<CircleF, RectangleF>("circle_rectangle", hitRatio, 0, 0, testNbr));
+		results.push_back(MeasureIntersect<RectangleF, RectangleF>("rectangle_rectangle", hitRatio, 0, 0, testNbr));
+		results.push_back(MeasureIntersect<CircleF, OrientedRectangleF>("circle_oriented_rectangle", hitRatio, 0, 0, testNbr));
+		results.push_back(MeasureIntersect<RectangleF, OrientedRectangleF>("rectangle_oriented_rectangle", hitRatio, 0, 0, testNbr));
+		results.push_back(MeasureIntersect<OrientedRectangleF, OrientedRectangleF>("oriented_rectangle_oriented_rectangle", hitRatio, 0, 0, testNbr));
+		results.push_back(MeasureOverlap<CircleF, CircleF>("overlap_circle_circle", hitRatio, 0, 0, testNbr));
+		results.push_back(MeasureOverlap<RectangleF, RectangleF>("overlap_rectangle_rectangle", hitRatio, 0, 0, testNbr));
+		results.push_back(MeasureOverlap<OrientedRectangleF, OrientedRectangleF>("overlap_oriented_rectangle_oriented_rectangle", hitRatio, 0, 0, testNbr));
+
+		for (int vertexCount = MIN_VERTICES; vertexCount <= MAX_VERTICES; ++vertexCount)
+		{
+			results.push_back(MeasureIntersect<CircleF, PolygonF>("circle_polygon", hitRatio, 0, vertexCount, testNbr));
+			results.push_back(MeasureIntersect<RectangleF, PolygonF>("rectangle_polygon", hitRatio, 0, vertexCount, testNbr));
+			results.push_back(MeasureIntersect<PolygonF, PolygonF>("polygon_polygon", hitRatio, vertexCount, vertexCount, testNbr));
+			results.push_back(MeasureOverlap<CircleF, PolygonF>("overlap_circle_polygon", hitRatio, 0, vertexCount, testNbr));
+			results.push_back(MeasureOverlap<PolygonF, PolygonF>("overlap_polygon_polygon", hitRatio, vertexCount, vertexCount, testNbr));
+		}
+	}
+	results.push_back(MeasureClosestPointOnSegment(testNbr));
+
+	if (outputPath.empty())
+	{
+		WriteJson(std::cout, testNbr, results);
+		return EXIT_SUCCESS;
+	}
+
+	std::ofstream file(outputPath);
+	if (!file)
+	{
+		std::cerr << "Cannot open " << outputPath << "\n";
+		return EXIT_FAILURE;
+	}
+	WriteJson(file, testNbr, results);
+
+	return EXIT_SUCCESS;
+}
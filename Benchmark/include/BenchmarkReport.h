@@ -0,0 +1,81 @@
+#pragma once
+
+#include "Scenario.h"
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Summary of a series of per frame measures, in milliseconds.
+ */
+struct Statistics
+{
+	double Mean = 0.0;
+	double Min = 0.0;
+	double Median = 0.0;
+	double P95 = 0.0;
+	double Max = 0.0;
+};
+
+/**
+ * @brief Measures of one scenario run at a given body count.
+ */
+struct ScenarioResult
+{
+	std::string Name;
+	std::size_t BodyCount = 0;
+	std::size_t FrameCount = 0;
+
+	Statistics Total; /**< Whole frame: scripted forces and world update. */
+	Statistics Integrate;
+	Statistics QuadTreeBuild;
+	Statistics Narrowphase;
+	Statistics Solve;
+
+	double MeanPairTests = 0.0;
+	double MeanContacts = 0.0;
+
+	double MeanLeaves = 0.0; /**< Leaves of the QuadTree. */
+	double MeanMaxLeafColliders = 0.0; /**< Colliders of the fullest leaf. */
+	double MeanOverfullLeaves = 0.0; /**< Leaves over the collider limit, stopped by the depth limit. */
+	int MaxColliders = 0; /**< Collider limit of the QuadTree at the last frame. */
+	int MaxDepth = 0; /**< Depth limit of the QuadTree at the last frame. */
+};
+
+/**
+ * @brief Settings of a benchmark run, shared by every scenario.
+ */
+struct BenchmarkSettings
+{
+	std::size_t WarmUpFrameCount = 60; /**< Frames simulated before measuring, to let the scene settle. */
+	std::size_t FrameCount = 600; /**< Measured frames. */
+	float DeltaTime = 1.f / 60.f; /**< Fixed time step, so that runs are comparable. */
+	unsigned int Seed = 42;
+	bool IsSleepingEnabled = false;
+	bool IsLooseQuadTree = false;
+	bool IsQuadTreeTuned = false;
+};
+
+/**
+ * @brief Compute the summary of a series of measures.
+ * @param samples The measures, reordered by the call.
+ */
+[[nodiscard]] Statistics ComputeStatistics(std::vector<double>& samples) noexcept;
+
+/**
+ * @brief Set up a scenario, simulate it and collect the stage timings of every measured frame.
+ * @param scenario The scenario to run, torn down at the end of the run.
+ * @param bodyCount The number of bodies spawned by the scenario.
+ * @param settings The frame counts, time step and seed of the run.
+ * @return The statistics of the run.
+ */
+[[nodiscard]] ScenarioResult RunScenario(Scenario& scenario, std::size_t bodyCount, const BenchmarkSettings& settings) noexcept;
+
+/**
+ * @brief Write the results of a benchmark run as a JSON document.
+ * @param out The stream to write to.
+ * @param settings The settings the results were measured with.
+ * @param results The results of every scenario run.
+ */
+void WriteJson(std::ostream& out, const BenchmarkSettings& settings, const std::vector<ScenarioResult>& results);
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "World.h"
+
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Parameters shared by every benchmark scenario.
+ */
+struct ScenarioConfig
+{
+	std::size_t BodyCount = 300; /**< Number of bodies spawned by the scenario. */
+	unsigned int Seed = 42; /**< Seed of the scenario random generator, so that every run spawns the same scene. */
+	bool IsSleepingEnabled = false; /**< Let the resting bodies of the world fall asleep. */
+	bool IsLooseQuadTree = false; /**< Store each collider once in a loose QuadTree. */
+	bool IsQuadTreeTuned = false; /**< Tune the QuadTree limits at every step. */
+};
+
+/**
+ * @brief A scripted physics scene run without any window or renderer.
+ * @note It follows the life cycle of a Sample: set up once, then updated before every world step.
+ */
+class Scenario
+{
+public:
+	static constexpr float BASE_WIDTH = 1200.f; /**< Width of the scene at the reference body count, same as the samples window. */
+	static constexpr float BASE_HEIGHT = 800.f; /**< Height of the scene at the reference body count, same as the samples window. */
+
+protected:
+	World _world;
+
+	std::vector<BodyRef> _bodyRefs;
+	std::vector<ColliderRef> _colRefs;
+
+	std::mt19937 _randomGenerator;
+
+	float _width = BASE_WIDTH; /**< Width of the scene, scaled to keep the sample density. */
+	float _height = BASE_HEIGHT; /**< Height of the scene, scaled to keep the sample density. */
+
+public:
+	virtual ~Scenario() noexcept = default;
+
+	/**
+	 * @brief Get the name of the scenario, used as identifier in the report.
+	 */
+	[[nodiscard]] virtual std::string GetName() const noexcept = 0;
+
+	/**
+	 * @brief Set up the world and spawn the bodies of the scenario.
+	 * @param config The body count and seed of the run.
+	 */
+	void SetUp(const ScenarioConfig& config) noexcept;
+
+	/**
+	 * @brief Apply the scripted forces and step the world once.
+	 * @param deltaTime The time step for the simulation.
+	 */
+	void Update(float deltaTime) noexcept;
+
+	/**
+	 * @brief Destroy every body of the scenario.
+	 */
+	void TearDown() noexcept;
+
+	/**
+	 * @brief Get the stage timings of the last world update.
+	 */
+	[[nodiscard]] const WorldProfile& GetProfile() const noexcept { return _world.GetProfile(); }
+
+	/**
+	 * @brief Get the world of the scenario, to attach listeners to it.
+	 */
+	[[nodiscard]] World& GetWorld() noexcept { return _world; }
+
+protected:
+	/**
+	 * @brief Number of bodies for which the scene has the size of the samples window.
+	 * @note The scene area grows linearly with the body count so that the density matches the sample.
+	 */
+	[[nodiscard]] virtual std::size_t GetReferenceBodyCount() const noexcept = 0;
+
+	virtual void ScenarioSetUp(const ScenarioConfig& config) noexcept = 0;
+
+	virtual void ScenarioUpdate() noexcept = 0;
+
+	/**
+	 * @brief Get a random float from the seeded generator of the scenario.
+	 */
+	[[nodiscard]] float Range(float min, float max) noexcept;
+};
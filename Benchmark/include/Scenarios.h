@@ -0,0 +1,102 @@
+#pragma once
+
+#include "Scenario.h"
+#include "GravityTree.h"
+
+/**
+ * @brief Circles, rectangles and triangles flagged as triggers moving through each other, modeled on TriggerSample.
+ */
+class TriggerSoupScenario final : public Scenario, public ContactListener
+{
+private:
+	static constexpr float CIRCLE_RADIUS = 20.f;
+	static constexpr float RECTANGLE_SIZE = 40.f;
+	static constexpr float SPEED = 100.f;
+
+	std::vector<int> _triggerNbrPerCollider;
+
+public:
+	[[nodiscard]] std::string GetName() const noexcept override { return "trigger_soup"; }
+
+	void OnTriggerEnter(ColliderRef colRef1, ColliderRef colRef2) noexcept override;
+
+	void OnTriggerExit(ColliderRef colRef1, ColliderRef colRef2) noexcept override;
+
+	void OnCollisionEnter(ColliderRef colRef1, ColliderRef colRef2) noexcept override {}
+
+	void OnCollisionExit(ColliderRef colRef1, ColliderRef colRef2) noexcept override {}
+
+protected:
+	[[nodiscard]] std::size_t GetReferenceBodyCount() const noexcept override { return 300; }
+
+	void ScenarioSetUp(const ScenarioConfig& config) noexcept override;
+
+	void ScenarioUpdate() noexcept override;
+};
+
+/**
+ * @brief Circles and rectangles bouncing on each other inside the scene, modeled on BouncingCollisionSample.
+ */
+class BouncingCollisionScenario final : public Scenario
+{
+private:
+	static constexpr float CIRCLE_RADIUS = 30.f;
+	static constexpr float RECTANGLE_SIZE = 60.f;
+	static constexpr float SPEED = 200.f;
+
+public:
+	[[nodiscard]] std::string GetName() const noexcept override { return "bouncing_collision"; }
+
+protected:
+	[[nodiscard]] std::size_t GetReferenceBodyCount() const noexcept override { return 40; }
+
+	void ScenarioSetUp(const ScenarioConfig& config) noexcept override;
+
+	void ScenarioUpdate() noexcept override;
+};
+
+/**
+ * @brief Circles and rectangles falling and piling up on a static ground, modeled on GroundCollisionSample.
+ */
+class GroundStackingScenario final : public Scenario
+{
+private:
+	static constexpr float GRAVITY = 500.f;
+	static constexpr float SPACING = 50.f;
+
+public:
+	[[nodiscard]] std::string GetName() const noexcept override { return "ground_stacking"; }
+
+protected:
+	[[nodiscard]] std::size_t GetReferenceBodyCount() const noexcept override { return 200; }
+
+	void ScenarioSetUp(const ScenarioConfig& config) noexcept override;
+
+	void ScenarioUpdate() noexcept override;
+};
+
+/**
+ * @brief Planets orbiting around a sun using gravitational forces, modeled on StarSystemSample.
+ * @note Every body attracts the others through the Barnes-Hut gravity tree, its cost is part of the total frame time.
+ */
+class StarSystemScenario final : public Scenario
+{
+private:
+	static constexpr float G = 6.67f;
+	static constexpr float SUN_MASS = 1000000.f;
+	static constexpr float PLANET_MASS = 10.f;
+	static constexpr float SOFTENING = 5.f;
+
+	BodyRef _sunRef{};
+	GravityTree _gravityTree;
+
+public:
+	[[nodiscard]] std::string GetName() const noexcept override { return "star_system"; }
+
+protected:
+	[[nodiscard]] std::size_t GetReferenceBodyCount() const noexcept override { return 1000; }
+
+	void ScenarioSetUp(const ScenarioConfig& config) noexcept override;
+
+	void ScenarioUpdate() noexcept override;
+};
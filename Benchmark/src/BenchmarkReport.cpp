@@ -0,0 +1,146 @@
+#include "BenchmarkReport.h"
+
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+
+Statistics ComputeStatistics(std::vector<double>& samples) noexcept
+{
+	Statistics statistics;
+	if (samples.empty())
+	{
+		return statistics;
+	}
+
+	std::sort(samples.begin(), samples.end());
+
+	statistics.Mean = std::accumulate(samples.begin(), samples.end(), 0.0) / static_cast<double>(samples.size());
+	statistics.Min = samples.front();
+	statistics.Median = samples[samples.size() / 2];
+	statistics.P95 = samples[Min(samples.size() - 1, samples.size() * 95 / 100)];
+	statistics.Max = samples.back();
+
+	return statistics;
+}
+
+ScenarioResult RunScenario(Scenario& scenario, const std::size_t bodyCount, const BenchmarkSettings& settings) noexcept
+{
+	ScenarioConfig config;
+	config.BodyCount = bodyCount;
+	config.Seed = settings.Seed;
+	config.IsSleepingEnabled = settings.IsSleepingEnabled;
+	config.IsLooseQuadTree = settings.IsLooseQuadTree;
+	config.IsQuadTreeTuned = settings.IsQuadTreeTuned;
+
+	scenario.SetUp(config);
+
+	for (std::size_t i = 0; i < settings.WarmUpFrameCount; ++i)
+	{
+		scenario.Update(settings.DeltaTime);
+	}
+
+	std::vector<double> total, integrate, quadTreeBuild, narrowphase, solve;
+	total.reserve(settings.FrameCount);
+	integrate.reserve(settings.FrameCount);
+	quadTreeBuild.reserve(settings.FrameCount);
+	narrowphase.reserve(settings.FrameCount);
+	solve.reserve(settings.FrameCount);
+
+	double pairTests = 0.0;
+	double contacts = 0.0;
+	double leaves = 0.0;
+	double maxLeafColliders = 0.0;
+	double overfullLeaves = 0.0;
+
+	for (std::size_t i = 0; i < settings.FrameCount; ++i)
+	{
+		const auto start = std::chrono::high_resolution_clock::now();
+		scenario.Update(settings.DeltaTime);
+		total.push_back(std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count());
+
+		const auto& profile = scenario.GetProfile();
+		integrate.push_back(profile.IntegrateMs);
+		quadTreeBuild.push_back(profile.QuadTreeBuildMs);
+		narrowphase.push_back(profile.NarrowphaseMs);
+		solve.push_back(profile.SolveMs);
+		pairTests += static_cast<double>(profile.PairTests);
+		contacts += static_cast<double>(profile.Contacts);
+		leaves += static_cast<double>(profile.Tree.LeafCount);
+		maxLeafColliders += static_cast<double>(profile.Tree.MaxLeafItems);
+		overfullLeaves += static_cast<double>(profile.Tree.OverfullLeafCount);
+	}
+
+	const auto lastTree = scenario.GetProfile().Tree;
+
+	scenario.TearDown();
+
+	ScenarioResult result;
+	result.Name = scenario.GetName();
+	result.BodyCount = bodyCount;
+	result.FrameCount = settings.FrameCount;
+	result.Total = ComputeStatistics(total);
+	result.Integrate = ComputeStatistics(integrate);
+	result.QuadTreeBuild = ComputeStatistics(quadTreeBuild);
+	result.Narrowphase = ComputeStatistics(narrowphase);
+	result.Solve = ComputeStatistics(solve);
+	if (settings.FrameCount > 0)
+	{
+		result.MeanPairTests = pairTests / static_cast<double>(settings.FrameCount);
+		result.MeanContacts = contacts / static_cast<double>(settings.FrameCount);
+		result.MeanLeaves = leaves / static_cast<double>(settings.FrameCount);
+		result.MeanMaxLeafColliders = maxLeafColliders / static_cast<double>(settings.FrameCount);
+		result.MeanOverfullLeaves = overfullLeaves / static_cast<double>(settings.FrameCount);
+	}
+	result.MaxColliders = lastTree.MaxColliders;
+	result.MaxDepth = lastTree.MaxDepth;
+
+	return result;
+}
+
+static void WriteStatistics(std::ostream& out, const char* name, const Statistics& statistics, const bool isLast)
+{
+	out << "        \"" << name << "\": {\"mean\": " << statistics.Mean
+		<< ", \"min\": " << statistics.Min
+		<< ", \"median\": " << statistics.Median
+		<< ", \"p95\": " << statistics.P95
+		<< ", \"max\": " << statistics.Max << "}" << (isLast ? "\n" : ",\n");
+}
+
+void WriteJson(std::ostream& out, const BenchmarkSettings& settings, const std::vector<ScenarioResult>& results)
+{
+	out << "{\n";
+	out << "  \"warmup_frames\": " << settings.WarmUpFrameCount << ",\n";
+	out << "  \"frames\": " << settings.FrameCount << ",\n";
+	out << "  \"delta_time\": " << settings.DeltaTime << ",\n";
+	out << "  \"seed\": " << settings.Seed << ",\n";
+	out << "  \"sleeping\": " << (settings.IsSleepingEnabled ? "true" : "false") << ",\n";
+	out << "  \"loose_quadtree\": " << (settings.IsLooseQuadTree ? "true" : "false") << ",\n";
+	out << "  \"quadtree_tuning\": " << (settings.IsQuadTreeTuned ? "true" : "false") << ",\n";
+	out << "  \"results\": [\n";
+
+	for (std::size_t i = 0; i < results.size(); ++i)
+	{
+		const auto& result = results[i];
+		out << "    {\n";
+		out << "      \"scenario\": \"" << result.Name << "\",\n";
+		out << "      \"bodies\": " << result.BodyCount << ",\n";
+		out << "      \"mean_pair_tests\": " << result.MeanPairTests << ",\n";
+		out << "      \"mean_contacts\": " << result.MeanContacts << ",\n";
+		out << "      \"quadtree\": {\"mean_leaves\": " << result.MeanLeaves
+			<< ", \"mean_max_leaf_colliders\": " << result.MeanMaxLeafColliders
+			<< ", \"mean_overfull_leaves\": " << result.MeanOverfullLeaves
+			<< ", \"max_colliders\": " << result.MaxColliders
+			<< ", \"max_depth\": " << result.MaxDepth << "},\n";
+		out << "      \"stages_ms\": {\n";
+		WriteStatistics(out, "total", result.Total, false);
+		WriteStatistics(out, "integrate", result.Integrate, false);
+		WriteStatistics(out, "quadtree_build", result.QuadTreeBuild, false);
+		WriteStatistics(out, "narrowphase", result.Narrowphase, false);
+		WriteStatistics(out, "solve", result.Solve, true);
+		out << "      }\n";
+		out << "    }" << (i + 1 < results.size() ? ",\n" : "\n");
+	}
+
+	out << "  ]\n";
+	out << "}\n";
+}
@@ -0,0 +1,46 @@
+#include "Scenario.h"
+
+#include <cmath>
+
+void Scenario::SetUp(const ScenarioConfig& config) noexcept
+{
+	_randomGenerator.seed(config.Seed);
+
+	const float scale = std::sqrt(static_cast<float>(config.BodyCount) / static_cast<float>(GetReferenceBodyCount()));
+	_width = BASE_WIDTH * Max(scale, 1.f);
+	_height = BASE_HEIGHT * Max(scale, 1.f);
+
+	_world.SetUp(static_cast<int>(config.BodyCount) + 1);
+	_world.SetProfilingEnabled(true);
+	_world.SetSleepingEnabled(config.IsSleepingEnabled);
+	_world.SetLooseQuadTree(config.IsLooseQuadTree);
+	_world.SetQuadTreeTuning(config.IsQuadTreeTuned);
+	_bodyRefs.reserve(config.BodyCount + 1);
+	_colRefs.reserve(config.BodyCount + 1);
+
+	ScenarioSetUp(config);
+}
+
+void Scenario::Update(const float deltaTime) noexcept
+{
+	ScenarioUpdate();
+	_world.Update(deltaTime);
+}
+
+void Scenario::TearDown() noexcept
+{
+	_bodyRefs.clear();
+	_colRefs.clear();
+	_world.TearDown();
+}
+
+float Scenario::Range(float min, float max) noexcept
+{
+	if (min > max)
+	{
+		std::swap(min, max);
+	}
+	std::uniform_real_distribution<float> dis(min, max);
+
+	return dis(_randomGenerator);
+}
@@ -0,0 +1,184 @@
+#include "Scenarios.h"
+
+#include <cmath>
+
+void TriggerSoupScenario::OnTriggerEnter(ColliderRef colRef1, ColliderRef colRef2) noexcept
+{
+	_triggerNbrPerCollider[colRef1.Index()]++;
+	_triggerNbrPerCollider[colRef2.Index()]++;
+}
+
+void TriggerSoupScenario::OnTriggerExit(ColliderRef colRef1, ColliderRef colRef2) noexcept
+{
+	_triggerNbrPerCollider[colRef1.Index()]--;
+	_triggerNbrPerCollider[colRef2.Index()]--;
+}
+
+void TriggerSoupScenario::ScenarioSetUp(const ScenarioConfig& config) noexcept
+{
+	_world.SetContactListener(this);
+	_world.SetBounds(RectangleF(XMVectorZero(), XMVectorSet(_width, _height, 0, 0)));
+
+	const std::vector<XMVECTOR> triangleVertices = {
+		XMVectorSet(0.f, -20.f, 0, 0),
+		XMVectorSet(20.f, 20.f, 0, 0),
+		XMVectorSet(-20.f, 20.f, 0, 0)
+	};
+
+	for (std::size_t i = 0; i < config.BodyCount; ++i)
+	{
+		const auto bodyRef = _world.CreateBody();
+		_bodyRefs.push_back(bodyRef);
+		auto& body = _world.GetBody(bodyRef);
+		body.Velocity = XMVectorScale(XMVectorSet(Range(-1.f, 1.f), Range(-1.f, 1.f), 0, 0), SPEED);
+		body.Position = XMVectorSet(Range(100.f, _width - 100.f), Range(100.f, _height - 100.f), 0, 0);
+
+		const auto colRef = _world.CreateCollider(bodyRef);
+		_colRefs.push_back(colRef);
+		auto& col = _world.GetCollider(colRef);
+		switch (i % 3)
+		{
+		case 0:
+			col.Shape = CircleF(XMVectorZero(), CIRCLE_RADIUS);
+			break;
+		case 1:
+			col.Shape = RectangleF(XMVectorZero(), XMVectorSet(RECTANGLE_SIZE, RECTANGLE_SIZE, 0, 0));
+			break;
+		default:
+			col.Shape = PolygonF(triangleVertices);
+			break;
+		}
+		col.BodyPosition = body.Position;
+		col.IsTrigger = true;
+	}
+
+	// Collider indices may be sparse, size the counters on the highest one
+	std::size_t maxIndex = 0;
+	for (const auto& colRef : _colRefs)
+	{
+		maxIndex = Max(maxIndex, colRef.Index());
+	}
+	_triggerNbrPerCollider.assign(maxIndex + 1, 0);
+}
+
+void TriggerSoupScenario::ScenarioUpdate() noexcept
+{
+	// The world bounds keep the bodies in the scene
+}
+
+void BouncingCollisionScenario::ScenarioSetUp(const ScenarioConfig& config) noexcept
+{
+	_world.SetBounds(RectangleF(XMVectorZero(), XMVectorSet(_width, _height, 0, 0)));
+
+	for (std::size_t i = 0; i < config.BodyCount; ++i)
+	{
+		const auto bodyRef = _world.CreateBody();
+		_bodyRefs.push_back(bodyRef);
+		auto& body = _world.GetBody(bodyRef);
+		body.Mass = 1;
+		body.Velocity = XMVectorScale(XMVectorSet(Range(-1.f, 1.f), Range(-1.f, 1.f), 0, 0), SPEED);
+		body.Position = XMVectorSet(Range(100.f, _width - 100.f), Range(100.f, _height - 100.f), 0, 0);
+
+		const auto colRef = _world.CreateCollider(bodyRef);
+		_colRefs.push_back(colRef);
+		auto& col = _world.GetCollider(colRef);
+		if (i % 2 == 0)
+		{
+			col.Shape = CircleF(XMVectorZero(), CIRCLE_RADIUS);
+		}
+		else
+		{
+			col.Shape = RectangleF(XMVectorZero(), XMVectorSet(RECTANGLE_SIZE, RECTANGLE_SIZE, 0, 0));
+		}
+		col.BodyPosition = body.Position;
+	}
+}
+
+void BouncingCollisionScenario::ScenarioUpdate() noexcept
+{
+	// The world bounds keep the bodies in the scene
+}
+
+void GroundStackingScenario::ScenarioSetUp(const ScenarioConfig& config) noexcept
+{
+	_world.SetGravity(XMVectorSet(0.f, GRAVITY, 0, 0));
+
+	const auto groundRef = _world.CreateBody();
+	_bodyRefs.push_back(groundRef);
+	auto& ground = _world.GetBody(groundRef);
+	ground.Type = BodyType::STATIC;
+	ground.Mass = 1;
+	ground.Position = XMVectorSet(_width / 2.f, _height - _height / 5.f, 0, 0);
+
+	const auto groundColRef = _world.CreateCollider(groundRef);
+	_colRefs.push_back(groundColRef);
+	auto& groundCol = _world.GetCollider(groundColRef);
+	groundCol.Shape = RectangleF(XMVectorSet(-_width / 3.f, 0.f, 0, 0), XMVectorSet(_width / 3.f, 20.f, 0, 0));
+	groundCol.BodyPosition = ground.Position;
+	groundCol.Restitution = 1.f;
+
+	// Drop the bodies on a grid above the ground, the columns span the ground width
+	const auto columnNbr = static_cast<std::size_t>(2.f * _width / 3.f / SPACING);
+	for (std::size_t i = 0; i < config.BodyCount; ++i)
+	{
+		const auto column = i % columnNbr;
+		const auto row = i / columnNbr;
+
+		const auto bodyRef = _world.CreateBody();
+		_bodyRefs.push_back(bodyRef);
+		auto& body = _world.GetBody(bodyRef);
+		body.Mass = 1;
+		body.Position = XMVectorSet(_width / 6.f + SPACING * (static_cast<float>(column) + 0.5f),
+			XMVectorGetY(ground.Position) - SPACING * (static_cast<float>(row) + 1.f), 0, 0);
+
+		const auto colRef = _world.CreateCollider(bodyRef);
+		_colRefs.push_back(colRef);
+		auto& col = _world.GetCollider(colRef);
+		if (i % 2 == 0)
+		{
+			col.Shape = CircleF(XMVectorZero(), Range(10.f, 20.f));
+		}
+		else
+		{
+			const float halfSize = Range(10.f, 20.f);
+			col.Shape = RectangleF(XMVectorSet(-halfSize, -halfSize, 0, 0), XMVectorSet(halfSize, halfSize, 0, 0));
+		}
+		col.BodyPosition = body.Position;
+		col.Restitution = 0.f;
+	}
+}
+
+void GroundStackingScenario::ScenarioUpdate() noexcept
+{
+	// The world applies the gravity, without keeping the resting bodies awake
+}
+
+void StarSystemScenario::ScenarioSetUp(const ScenarioConfig& config) noexcept
+{
+	_gravityTree.SetGravitationalConstant(G);
+	_gravityTree.SetSoftening(SOFTENING);
+
+	_sunRef = _world.CreateBody();
+	_bodyRefs.push_back(_sunRef);
+	auto& sun = _world.GetBody(_sunRef);
+	sun.Position = XMVectorSet(_width / 2.f, _height / 2.f, 0, 0);
+	sun.Mass = SUN_MASS;
+
+	for (std::size_t i = 0; i < config.BodyCount; ++i)
+	{
+		const auto bodyRef = _world.CreateBody();
+		_bodyRefs.push_back(bodyRef);
+		auto& body = _world.GetBody(bodyRef);
+		body.Position = XMVectorSet(Range(100.f, _width - 100.f), Range(100.f, _height - 100.f), 0, 0);
+
+		const auto r = XMVectorSubtract(_world.GetBody(_sunRef).Position, body.Position);
+		const auto v = std::sqrt(G * (SUN_MASS / XMVectorGetX(XMVector3Length(r))));
+		body.Velocity = XMVectorScale(XMVector3Normalize(XMVectorSet(-XMVectorGetY(r), XMVectorGetX(r), 0, 0)), v);
+		body.Mass = PLANET_MASS;
+	}
+}
+
+void StarSystemScenario::ScenarioUpdate() noexcept
+{
+	_gravityTree.ApplyForces(_world.GetBodies());
+}
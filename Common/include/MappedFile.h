@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief A read only file mapped in memory, so that large files are paged in on access instead of read at once.
+ * @note Uses the file mapping of Windows and mmap on the other platforms.
+ */
+class MappedFile
+{
+private:
+#ifdef _WIN32
+    void* _file = nullptr; // Handle of the opened file.
+    void* _mapping = nullptr; // Handle of the file mapping.
+#else
+    int _file = -1; // Descriptor of the opened file.
+#endif
+    const std::uint8_t* _data = nullptr; // First byte of the mapped file.
+    std::size_t _size = 0; // Size of the mapped file in bytes.
+
+public:
+    MappedFile() noexcept = default;
+    ~MappedFile() noexcept;
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Map a whole file, closing the previously mapped one.
+     * @param path The path of the file.
+     * @throws std::runtime_error if the file cannot be opened or mapped, or is empty.
+     */
+    void Open(const std::string& path);
+
+    /**
+     * @brief Unmap and close the file.
+     */
+    void Close() noexcept;
+
+    [[nodiscard]] bool IsOpen() const noexcept { return _data != nullptr; }
+    [[nodiscard]] const std::uint8_t* Data() const noexcept { return _data; }
+    [[nodiscard]] std::size_t Size() const noexcept { return _size; }
+};
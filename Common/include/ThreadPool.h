@@ -0,0 +1,74 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Workers kept alive between parallel loops, so that a loop run every frame does not create threads.
+ * @note The workers are started by the first loop that needs them, a pool never used costs no thread.
+ * The calling thread takes part in every loop, which returns once each worker has left it.
+ */
+class ThreadPool
+{
+private:
+    using ChunkFunction = void (*)(const void* task, std::size_t chunk);
+
+    std::vector<std::thread> _workers; // The threads helping the calling thread.
+    std::size_t _workerCount = 0; // The number of workers to start, fixed at construction.
+
+    std::mutex _mutex;
+    std::condition_variable _wakeUp; // Signalled when a loop starts or the pool stops.
+    std::condition_variable _done; // Signalled when the last worker leaves a loop.
+
+    const void* _task = nullptr; // The task of the current loop.
+    ChunkFunction _runChunk = nullptr; // Runs one chunk of the current task.
+    std::size_t _chunkCount = 0; // The number of chunks of the current loop.
+    std::size_t _nextChunk = 0; // The first chunk not taken yet, guarded by the mutex.
+    std::size_t _busyWorkers = 0; // The workers not done with the current loop.
+    std::uint64_t _loop = 0; // Increased by each loop, so that a worker joins each loop once.
+    bool _isStopping = false;
+
+public:
+    /**
+     * @brief Constructor for ThreadPool.
+     * @param workerCount The number of threads helping the calling thread, 0 uses the hardware concurrency.
+     */
+    explicit ThreadPool(std::size_t workerCount = 0) noexcept;
+    ~ThreadPool() noexcept;
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Get the number of threads running a loop, the calling thread included.
+     */
+    [[nodiscard]] std::size_t GetThreadCount() const noexcept { return _workerCount + 1; }
+
+    /**
+     * @brief Run a task on every chunk of a loop, spread over the workers and the calling thread.
+     * @param chunkCount The number of chunks, a single chunk runs on the calling thread alone.
+     * @param task The function called with the index of each chunk, from any of the threads.
+     */
+    template<typename Task>
+    void Run(const std::size_t chunkCount, const Task& task) noexcept
+    {
+        Dispatch(chunkCount, &task, [](const void* context, const std::size_t chunk)
+            {
+                (*static_cast<const Task*>(context))(chunk);
+            });
+    }
+
+private:
+    void Dispatch(std::size_t chunkCount, const void* task, ChunkFunction runChunk) noexcept;
+
+    /**
+     * @brief Take and run the chunks of the current loop until none is left.
+     */
+    void RunChunks(std::unique_lock<std::mutex>& lock) noexcept;
+
+    void WorkerLoop() noexcept;
+};
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @brief Lock-free handoff of values from one producer thread to one consumer thread.
+ * @tparam T The type of the values, written in place so that their capacity is kept.
+ * @note The producer writes the back buffer then publishes it, the consumer acquires the latest published buffer.
+ * Neither ever waits for the other: the third buffer sits between them and is swapped with an atomic exchange.
+ */
+template<typename T>
+class TripleBuffer
+{
+private:
+    static constexpr std::uint8_t INDEX_MASK = 0b011; // The bits of the buffer index.
+    static constexpr std::uint8_t FRESH_BIT = 0b100; // Set when the middle buffer was published and not acquired yet.
+
+    std::array<T, 3> _buffers{};
+
+    std::atomic<std::uint8_t> _middle{1}; // The index of the buffer between the threads, with its fresh bit.
+    std::uint8_t _back = 0; // The index of the buffer written by the producer.
+    std::uint8_t _front = 2; // The index of the buffer read by the consumer.
+
+public:
+    /**
+     * @brief Get the buffer to write, only from the producer thread.
+     */
+    [[nodiscard]] T &Back() noexcept { return _buffers[_back]; }
+
+    /**
+     * @brief Hand the back buffer to the consumer, the producer gets the middle buffer to write next.
+     */
+    void Publish() noexcept
+    {
+        _back = _middle.exchange(_back | FRESH_BIT, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    /**
+     * @brief Take the latest published buffer as the front buffer, only from the consumer thread.
+     * @return True if a new buffer was acquired, false if the front buffer is still the latest one.
+     */
+    bool Acquire() noexcept
+    {
+        if ((_middle.load(std::memory_order_relaxed) & FRESH_BIT) == 0)
+        {
+            return false;
+        }
+        _front = _middle.exchange(_front, std::memory_order_acq_rel) & INDEX_MASK;
+        return true;
+    }
+
+    /**
+     * @brief Get the buffer to read, only from the consumer thread.
+     */
+    [[nodiscard]] const T &Front() const noexcept { return _buffers[_front]; }
+};
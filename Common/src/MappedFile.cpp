@@ -0,0 +1,120 @@
+#include "MappedFile.h"
+
+#include <stdexcept>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile() noexcept
+{
+    Close();
+}
+
+#ifdef _WIN32
+
+void MappedFile::Open(const std::string& path)
+{
+    Close();
+
+    _file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (_file == INVALID_HANDLE_VALUE)
+    {
+        _file = nullptr;
+        throw std::runtime_error("Cannot open " + path + " !");
+    }
+
+    LARGE_INTEGER size{};
+    if (!GetFileSizeEx(_file, &size) || size.QuadPart == 0)
+    {
+        Close();
+        throw std::runtime_error("Cannot map the empty file " + path + " !");
+    }
+
+    _mapping = CreateFileMappingA(_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    const void* view = _mapping != nullptr ? MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (view == nullptr)
+    {
+        Close();
+        throw std::runtime_error("Cannot map " + path + " !");
+    }
+
+    _data = static_cast<const std::uint8_t*>(view);
+    _size = static_cast<std::size_t>(size.QuadPart);
+}
+
+void MappedFile::Close() noexcept
+{
+    if (_data != nullptr)
+    {
+        UnmapViewOfFile(_data);
+    }
+    if (_mapping != nullptr)
+    {
+        CloseHandle(_mapping);
+    }
+    if (_file != nullptr)
+    {
+        CloseHandle(_file);
+    }
+
+    _file = nullptr;
+    _mapping = nullptr;
+    _data = nullptr;
+    _size = 0;
+}
+
+#else
+
+void MappedFile::Open(const std::string& path)
+{
+    Close();
+
+    _file = open(path.c_str(), O_RDONLY);
+    if (_file < 0)
+    {
+        throw std::runtime_error("Cannot open " + path + " !");
+    }
+
+    struct stat status{};
+    if (fstat(_file, &status) != 0 || status.st_size == 0)
+    {
+        Close();
+        throw std::runtime_error("Cannot map the empty file " + path + " !");
+    }
+
+    void* view = mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ, MAP_PRIVATE, _file, 0);
+    if (view == MAP_FAILED)
+    {
+        Close();
+        throw std::runtime_error("Cannot map " + path + " !");
+    }
+
+    _data = static_cast<const std::uint8_t*>(view);
+    _size = static_cast<std::size_t>(status.st_size);
+}
+
+void MappedFile::Close() noexcept
+{
+    if (_data != nullptr)
+    {
+        munmap(const_cast<std::uint8_t*>(_data), _size);
+    }
+    if (_file >= 0)
+    {
+        close(_file);
+    }
+
+    _file = -1;
+    _data = nullptr;
+    _size = 0;
+}
+
+#endif
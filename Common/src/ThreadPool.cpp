@@ -0,0 +1,92 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+ThreadPool::ThreadPool(const std::size_t workerCount) noexcept :
+    _workerCount(workerCount > 0 ? workerCount : std::max<std::size_t>(1, std::thread::hardware_concurrency()) - 1)
+{
+}
+
+ThreadPool::~ThreadPool() noexcept
+{
+    {
+        std::lock_guard lock(_mutex);
+        _isStopping = true;
+    }
+    _wakeUp.notify_all();
+
+    for (auto& worker : _workers)
+    {
+        worker.join();
+    }
+}
+
+void ThreadPool::Dispatch(const std::size_t chunkCount, const void* task, const ChunkFunction runChunk) noexcept
+{
+    if (chunkCount <= 1 || _workerCount == 0)
+    {
+        for (std::size_t chunk = 0; chunk < chunkCount; ++chunk)
+        {
+            runChunk(task, chunk);
+        }
+        return;
+    }
+
+    std::unique_lock lock(_mutex);
+    if (_workers.empty())
+    {
+        _workers.reserve(_workerCount);
+        for (std::size_t i = 0; i < _workerCount; ++i)
+        {
+            _workers.emplace_back(&ThreadPool::WorkerLoop, this);
+        }
+    }
+
+    _task = task;
+    _runChunk = runChunk;
+    _chunkCount = chunkCount;
+    _nextChunk = 0;
+    _busyWorkers = _workers.size();
+    _loop++;
+    _wakeUp.notify_all();
+
+    RunChunks(lock);
+
+    // The task lives on the stack of the caller, no worker may still hold it once the loop returns
+    _done.wait(lock, [this]() { return _busyWorkers == 0; });
+    _task = nullptr;
+    _runChunk = nullptr;
+}
+
+void ThreadPool::RunChunks(std::unique_lock<std::mutex>& lock) noexcept
+{
+    while (_nextChunk < _chunkCount)
+    {
+        const std::size_t chunk = _nextChunk++;
+        lock.unlock();
+        _runChunk(_task, chunk);
+        lock.lock();
+    }
+}
+
+void ThreadPool::WorkerLoop() noexcept
+{
+    std::uint64_t lastLoop = 0;
+    std::unique_lock lock(_mutex);
+    while (true)
+    {
+        _wakeUp.wait(lock, [this, lastLoop]() { return _isStopping || _loop != lastLoop; });
+        if (_isStopping)
+        {
+            return;
+        }
+        lastLoop = _loop;
+
+        RunChunks(lock);
+
+        if (--_busyWorkers == 0)
+        {
+            _done.notify_one();
+        }
+    }
+}
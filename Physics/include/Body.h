@@ -14,12 +14,18 @@ class Body {
 public:
 	XMVECTOR Position = XMVectorZero();
 	XMVECTOR Velocity = XMVectorZero();
+	XMVECTOR PreviousPosition = XMVectorZero(); // Position at the start of the last step, used to interpolate the rendering
 
 	float Mass = -1.f;  // Body is disabled if mass is negative
 	BodyType Type = BodyType::DYNAMIC;
 
+	float SleepTime = 0.f; // Time the body has been resting, it falls asleep once its whole island rested long enough
+
+	bool IsContinuous = false; // Swept from its previous position in the collision checks, so that a fast body cannot tunnel through thin colliders
+
 private:
 	XMVECTOR _force = XMVectorZero(); // Total force acting on the body
+	bool _isAwake = true; // A sleeping body is neither integrated nor moved in the broadphase
 
 public:
 	/**
@@ -41,8 +47,9 @@ public:
 	/**
 	 * @brief Apply a force to the body.
 	 * @param force The force to be applied.
+	 * @param wakeUp Flag indicating if a sleeping body is woken up, otherwise the force is ignored while it sleeps.
 	 */
-	void ApplyForce(const XMVECTOR& force) noexcept;
+	void ApplyForce(const XMVECTOR& force, bool wakeUp = true) noexcept;
 
 	/**
 	 * @brief Check if the body is enabled (mass is non-negative).
@@ -70,4 +77,30 @@ public:
 	 * @brief Reset the total force acting on the body to zero.
 	 */
 	void ResetForce() { _force = XMVectorZero(); }
+
+	/**
+	 * @brief Check if the body is awake, static bodies never fall asleep.
+	 * @return true if the body is awake, false otherwise.
+	 */
+	[[nodiscard]] constexpr bool IsAwake() const noexcept { return _isAwake; }
+
+	/**
+	 * @brief Wake the body up and restart its resting time.
+	 * @note Call it after moving a sleeping body by hand.
+	 */
+	constexpr void WakeUp() noexcept
+	{
+		_isAwake = true;
+		SleepTime = 0.f;
+	}
+
+	/**
+	 * @brief Put the body to sleep, stopping it.
+	 */
+	void Sleep() noexcept
+	{
+		_isAwake = false;
+		Velocity = XMVectorZero();
+		_force = XMVectorZero();
+	}
 };
\ No newline at end of file
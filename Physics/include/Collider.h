@@ -3,6 +3,7 @@
 #include "Shape.h"
 #include "Refs.h"
 
+#include <cstdint>
 #include <variant>
 
 /**
@@ -10,6 +11,40 @@
  * @brief This file defines the `Shape`, `Collider`, `ColliderPair` and `ColliderPairHash` structures
  */
 
+using ColliderShape = std::variant<CircleF, RectangleF, PolygonF, OrientedRectangleF>; /**< Every shape a collider can have. */
+
+using ShapeId = std::uint32_t; /**< Index of a shape prototype registered in a world. */
+
+/**
+ * @brief Compute the bounding box of a shape placed at a position.
+ * @param shape The shape.
+ * @param position The position of the shape.
+ * @return The bounding box.
+ */
+[[nodiscard]] RectangleF GetBounds(const ColliderShape& shape, XMVECTOR position) noexcept;
+
+/**
+ * @brief Check if two shapes placed at positions overlap.
+ * @return true if the shapes overlap, false otherwise.
+ */
+[[nodiscard]] bool Overlap(const ColliderShape& shapeA, XMVECTOR positionA, const ColliderShape& shapeB, XMVECTOR positionB) noexcept;
+
+/**
+ * @brief Check if a shape placed at a position contains a point.
+ * @return true if the point is inside the shape, false otherwise.
+ */
+[[nodiscard]] bool Contains(const ColliderShape& shape, XMVECTOR position, XMVECTOR point) noexcept;
+
+/**
+ * @brief Cast a ray against a shape placed at a position.
+ * @param direction The normalized direction of the ray.
+ * @param maxDistance The length of the ray.
+ * @param distance The distance of the hit along the ray, written on hit.
+ * @param normal The normal of the shape at the hit, written on hit.
+ * @return true if the ray hits the shape, false otherwise.
+ */
+[[nodiscard]] bool RayCast(const ColliderShape& shape, XMVECTOR position, XMVECTOR origin, XMVECTOR direction,
+	float maxDistance, float& distance, XMVECTOR& normal) noexcept;
 
 
  /**
@@ -19,7 +54,9 @@
 class Collider
 {
 public:
-	std::variant<CircleF, RectangleF, PolygonF> Shape{
+	static constexpr std::uint32_t ALL_LAYERS = 0xFFFFFFFF; /**< Layer mask accepting every category. */
+
+	ColliderShape Shape{
 			CircleF(XMVectorZero(), 1) }; /**< The shape associated with the collider. */
 
 	BodyRef BodyRef; /**< Reference to the body associated with the collider. */
@@ -28,6 +65,9 @@ public:
 
 	float Restitution = 1.f; /**< Bounciness/Restition of the collider. */
 
+	std::uint32_t CategoryBits = 1; /**< Layers the collider belongs to, matched against the masks of the other colliders and of the queries. */
+	std::uint32_t MaskBits = ALL_LAYERS; /**< Layers the collider collides with, two colliders are tested only if each one accepts the other. */
+
 	bool IsTrigger = false; /**< Flag indicating if the collider is a trigger (non-physical). */
 	bool IsAttached = false; /**< Flag indicating if the collider is attached to a body. */
 
@@ -43,6 +83,16 @@ struct ColliderRefPair
 	ColliderRef ColRefA; /**< The first colliderRef in the pair. */
 	ColliderRef ColRefB; /**< The second colliderRef in the pair. */
 
+	/**
+	 * @brief Get the key of the pair, the two packed references with the smallest first, the same for both orders.
+	 */
+	[[nodiscard]] std::uint64_t Key() const noexcept
+	{
+		const std::uint32_t a = ColRefA.Value;
+		const std::uint32_t b = ColRefB.Value;
+		return a < b ? (static_cast<std::uint64_t>(a) << 32) | b : (static_cast<std::uint64_t>(b) << 32) | a;
+	}
+
 	bool operator==(const ColliderRefPair& other) const;
 
 };
@@ -56,7 +106,7 @@ struct ColliderRefPairHash
 	/**
 	 * @brief Calculate a hash value for a collider pair.
 	 * @param pair The collider pair to hash.
-	 * @return The hash value based on the individual hash values of the colliders.
+	 * @return The hash value of the key of the pair.
 	 */
 	std::size_t operator()(const ColliderRefPair& pair) const;
 };
\ No newline at end of file
@@ -0,0 +1,138 @@
+#pragma once
+
+#include "Body.h"
+#include "Shape.h"
+#include "ThreadPool.h"
+
+#include <array>
+#include <vector>
+
+/**
+ * @brief Class representing a node of the gravity tree, holding the mass of every body inside its bounds.
+ */
+class GravityNode
+{
+public:
+	RectangleF Bounds{ XMVectorZero(), XMVectorZero() }; /**< The square bounds of the node. */
+	XMVECTOR CenterOfMass = XMVectorZero(); /**< Mass weighted center of the bodies of the node. */
+	float Mass = 0.f; /**< Total mass of the bodies of the node. */
+	int FirstChild = -1; /**< Index of the first of the 4 consecutive child nodes, -1 for a leaf. */
+	int FirstBody = -1; /**< Index of the first body of a leaf, the next ones are chained. */
+	int BodyCount = 0; /**< Number of bodies chained in a leaf. */
+	int Depth = 0; /**< The depth of the node in the tree. */
+
+	/**
+	 * @brief Constructor for GravityNode with specified bounds and depth.
+	 * @param bounds The bounds of the node.
+	 * @param depth The depth of the node in the tree.
+	 */
+	explicit GravityNode(const RectangleF& bounds, int depth) noexcept : Bounds(bounds), Depth(depth) {}
+};
+
+/**
+ * @brief Barnes-Hut approximation of the gravitational attraction between every body.
+ * @note Bodies are inserted as points in a quadtree, each node summarising its mass and center of mass.
+ * Distant nodes, seen under an angle smaller than the opening angle, attract a body as a single mass,
+ * which brings the cost from O(n^2) down to O(n log n).
+ */
+class GravityTree
+{
+public:
+	std::vector<GravityNode> Nodes; /**< Nodes of the tree, children are always stored after their parent. */
+
+private:
+	static constexpr int MAX_BODY_NBR = 8; /**< Maximum number of bodies in a leaf, summed directly. */
+	static constexpr int MAX_DEPTH = 24; /**< Maximum depth of the tree, past it a leaf holds any number of bodies. */
+	static constexpr std::size_t MIN_BODIES_PER_THREAD = 1024; /**< Under this count a thread costs more than it saves. */
+
+	std::vector<int> _nextBodies; /**< Next body in the same leaf for each body, -1 ending the chain. */
+	std::vector<int> _sortedBodies; /**< Bodies in depth first order of their leaves, so that neighbours walk the same nodes. */
+
+	float _gravitationalConstant = 6.67f; /**< Scale of the attraction. */
+	float _openingAngle = 0.5f; /**< Ratio of node size over distance under which a node is approximated, 0 is exact. */
+	float _softening = 1.f; /**< Length added in quadrature to every distance, avoiding infinite forces between close bodies. */
+	std::size_t _threadCount = 0; /**< Number of threads computing the forces, 0 uses the hardware concurrency. */
+	ThreadPool _threadPool; /**< Workers computing the forces, kept between the steps. */
+
+public:
+	/**
+	 * @brief Set the gravitational constant.
+	 * @param gravitationalConstant The scale of the attraction.
+	 */
+	void SetGravitationalConstant(const float gravitationalConstant) noexcept { _gravitationalConstant = gravitationalConstant; }
+
+	/**
+	 * @brief Set the opening angle θ trading accuracy for speed.
+	 * @param openingAngle The node size over distance ratio under which a node is approximated by its center of mass.
+	 * @note A node containing the attracted body is always opened, whatever the angle.
+	 */
+	void SetOpeningAngle(const float openingAngle) noexcept { _openingAngle = openingAngle; }
+
+	/**
+	 * @brief Set the softening length of the attraction.
+	 * @param softening The length ε added in quadrature to every distance, the distance d being replaced by √(d² + ε²).
+	 */
+	void SetSoftening(const float softening) noexcept { _softening = softening; }
+
+	/**
+	 * @brief Set the number of threads computing the forces.
+	 * @param threadCount The number of chunks the bodies are split in, run by the workers of the tree, 0 uses the hardware concurrency.
+	 */
+	void SetThreadCount(const std::size_t threadCount) noexcept { _threadCount = threadCount; }
+
+	/**
+	 * @brief Build the tree with the enabled bodies of positive mass.
+	 * @param bodies The bodies of the world.
+	 */
+	void Build(const std::vector<Body>& bodies) noexcept;
+
+	/**
+	 * @brief Compute the gravitational acceleration of a body, the tree must have been built with the same bodies.
+	 * @param bodies The bodies of the world.
+	 * @param bodyIndex The index of the attracted body, which does not attract itself.
+	 * @return The acceleration, to be multiplied by the mass of the attracted body.
+	 */
+	[[nodiscard]] XMVECTOR ComputeAcceleration(const std::vector<Body>& bodies, std::size_t bodyIndex) const noexcept;
+
+	/**
+	 * @brief Build the tree and apply the gravitational force to every dynamic body, in parallel.
+	 * @param bodies The bodies of the world.
+	 * @note Sleeping bodies keep attracting the others but are not woken up by gravity.
+	 */
+	void ApplyForces(std::vector<Body>& bodies) noexcept;
+
+private:
+	/**
+	 * @brief Insert a body in the tree, subdividing the leaves it falls into.
+	 * @param bodyIndex The index of the body.
+	 * @param position The position of the body.
+	 * @param bodies The bodies of the world, to move the body of a subdivided leaf.
+	 */
+	void Insert(int bodyIndex, XMVECTOR position, const std::vector<Body>& bodies) noexcept;
+
+	/**
+	 * @brief Split a leaf into 4 children.
+	 * @param nodeIndex The index of the leaf to subdivide.
+	 */
+	void SubdivideNode(int nodeIndex) noexcept;
+
+	/**
+	 * @brief Get the index of the child of a node containing a position.
+	 */
+	[[nodiscard]] int ChildIndex(const GravityNode& node, XMVECTOR position) const noexcept;
+
+	/**
+	 * @brief Compute the masses and centers of mass, children first.
+	 */
+	void ComputeMasses(const std::vector<Body>& bodies) noexcept;
+
+	/**
+	 * @brief Store the bodies in depth first order of the leaves.
+	 */
+	void SortBodies() noexcept;
+
+	/**
+	 * @brief Apply the gravitational force to a range of the sorted bodies.
+	 */
+	void ApplyForces(std::vector<Body>& bodies, std::size_t begin, std::size_t end) const noexcept;
+};
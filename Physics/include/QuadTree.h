@@ -6,6 +6,8 @@
 
 #include <memory>
 #include <array>
+#include <cstdint>
+#include <vector>
 /**
  * @brief Structure representing a bounding box (AABB) associated with a collider reference.
  */
@@ -13,68 +15,283 @@ struct ColliderRefAabb
 {
 	const RectangleF Aabb;    /**< The bounding box (AABB). */
 	const ColliderRef ColRef;       /**< The reference to a collider. */
+	const bool IsStatic = false;    /**< Flag indicating if the collider body is static. */
+	const bool IsSleeping = false;  /**< Flag indicating if the collider body is asleep. */
+	const bool IsContinuous = false; /**< Flag indicating if the AABB is swept along the last move of the body. */
+	const bool IsTrigger = false;   /**< Flag indicating if the collider is a trigger. */
+	const std::uint32_t CategoryBits = 1; /**< Layers of the collider, copied so that pairs are filtered without reading the collider. */
+	const std::uint32_t MaskBits = Collider::ALL_LAYERS; /**< Layers the collider collides with. */
+};
+
+/**
+ * @brief Bounds quantized on 16 bits in the frame of a quadtree node.
+ * @note The minimum is rounded down and the maximum up, so that quantized bounds overlap whenever the exact ones do.
+ */
+struct QuantizedAabb
+{
+	std::uint16_t MinX = 0; /**< Left of the bounds, 0 is the left of the frame. */
+	std::uint16_t MinY = 0; /**< Top of the bounds, 0 is the top of the frame. */
+	std::uint16_t MaxX = 0; /**< Right of the bounds, 65535 is the right of the frame. */
+	std::uint16_t MaxY = 0; /**< Bottom of the bounds, 65535 is the bottom of the frame. */
+};
+
+/**
+ * @brief Check if two quantized bounds of the same frame overlap.
+ */
+[[nodiscard]] constexpr bool Intersect(const QuantizedAabb& aabb1, const QuantizedAabb& aabb2) noexcept
+{
+	return aabb1.MinX <= aabb2.MaxX && aabb2.MinX <= aabb1.MaxX && aabb1.MinY <= aabb2.MaxY && aabb2.MinY <= aabb1.MaxY;
+}
+
+/**
+ * @brief Compact entry of a quadtree node, 12 bytes instead of the 64 of a ColliderRefAabb.
+ */
+struct QuadTreeItem
+{
+	QuantizedAabb Aabb; /**< The bounds of the entry, in the frame of the item bounds of its node. */
+	std::uint32_t Entry = 0; /**< Index of the entry in the entries the tree was built from. */
 };
 
 /**
  * @brief Class representing a node in a quadtree data structure for collision detection.
+ * @note Nodes hold no pointer: the children of node i are the nodes 4i+1 to 4i+4, and the entries
+ * are a range of the item array of the tree.
  */
 class QuadNode
 {
 public:
-	CustomlyAllocatedVector<ColliderRefAabb> ColliderRefAabbs;  /**< Vector of collider references with AABBs. */
 	RectangleF Bounds{ XMVectorZero(), XMVectorZero() }; /**< The bounds of the quadtree node. */
-	std::array<QuadNode*, 4> Children{ nullptr, nullptr, nullptr, nullptr }; /**< Array of child nodes. */
+	RectangleF LooseBounds{ XMVectorZero(), XMVectorZero() }; /**< The bounds containing every entry of the node and its children, the bounds themselves in a tight tree. */
+	RectangleF ItemBounds{ XMVectorZero(), XMVectorZero() }; /**< Union of the bounds of the entries of the node, the frame of their quantized bounds. */
+	std::uint32_t FirstItem = 0; /**< Index of the first entry of the node in the item array. */
+	std::uint32_t ItemCount = 0; /**< Number of entries of the node. */
 	int Depth = 0; /**< The depth of the node in the quadtree.*/
+	bool IsLeaf = true; /**< Flag indicating if the node has no children. */
+};
 
+/**
+ * @brief Entries of a quadtree node whose quantized bounds overlap a query, the iteration skips the others.
+ * @note The quantized bounds are conservative, the entries met still need an exact test.
+ */
+class QuadNodeItems
+{
+public:
 	/**
-	 * @brief Constructor for QuadNode, allocating memory using a specified allocator.
-	 * @param alloc The allocator for memory allocation.
+	 * @brief Iterator over the overlapping entries, giving the full entry of each item.
 	 */
-	QuadNode(Allocator& alloc) noexcept;
+	class Iterator
+	{
+	public:
+		Iterator(const QuadTreeItem* item, const QuadNodeItems& items) noexcept : _item(item), _items(&items) { Skip(); }
+
+		[[nodiscard]] const ColliderRefAabb& operator*() const noexcept { return _items->_entries[_item->Entry]; }
+
+		Iterator& operator++() noexcept
+		{
+			++_item;
+			Skip();
+			return *this;
+		}
+
+		[[nodiscard]] bool operator!=(const Iterator& other) const noexcept { return _item != other._item; }
+
+	private:
+		void Skip() noexcept
+		{
+			while (_item != _items->_last && !Intersect(_item->Aabb, _items->_query))
+			{
+				++_item;
+			}
+		}
+
+		const QuadTreeItem* _item; /**< The current item. */
+		const QuadNodeItems* _items; /**< The range iterated. */
+	};
 
 	/**
-	 * @brief Constructor for QuadNode with a specified bounds, allocating memory using a specified allocator.
-	 * @param bounds The bounds of the quadtree node.
-	 * @param alloc The allocator for memory allocation.
+	 * @brief Constructor for QuadNodeItems.
+	 * @param first The first item of the node.
+	 * @param last The item following the last one of the node.
+	 * @param entries The entries the tree was built from.
+	 * @param query The quantized query, in the frame of the node.
+	 */
+	QuadNodeItems(const QuadTreeItem* first, const QuadTreeItem* last, const ColliderRefAabb* entries, const QuantizedAabb& query) noexcept :
+		_first(first), _last(last), _entries(entries), _query(query) {}
+
+	[[nodiscard]] Iterator begin() const noexcept { return { _first, *this }; }
+	[[nodiscard]] Iterator end() const noexcept { return { _last, *this }; }
+
+	/**
+	 * @brief Check if the node has no entry, whether they overlap the query or not.
 	 */
-	explicit QuadNode(const RectangleF& bounds, Allocator& alloc) noexcept;
+	[[nodiscard]] bool empty() const noexcept { return _first == _last; }
+
+private:
+	const QuadTreeItem* _first; /**< The first item of the node. */
+	const QuadTreeItem* _last; /**< The item following the last one of the node. */
+	const ColliderRefAabb* _entries; /**< The entries the tree was built from. */
+	QuantizedAabb _query; /**< The quantized query. */
+};
+
+/**
+ * @brief Shape of a built quadtree, to see where the time of a slow step went.
+ */
+struct QuadTreeStats
+{
+	std::size_t NodeCount = 0; /**< Number of nodes of the tree. */
+	std::size_t LeafCount = 0; /**< Number of leaves of the tree. */
+	std::size_t ItemCount = 0; /**< Number of entries stored, counting the copies of a tight tree. */
+	std::size_t MaxLeafItems = 0; /**< Number of entries of the fullest leaf. */
+	std::size_t OverfullLeafCount = 0; /**< Number of leaves over the collider limit, stopped by the depth limit. */
+	std::size_t LeafPairs = 0; /**< Number of pairs of entries sharing a leaf, tested by a tight tree unless filtered. */
+	int Depth = 0; /**< Depth of the deepest leaf. */
+	int MaxColliders = 0; /**< Collider limit the tree was built with. */
+	int MaxDepth = 0; /**< Depth limit the tree was built with. */
 };
 
 /**
  * @brief Class representing a quadtree data structure for collision detection.
+ * @note A tight tree keeps its entries in the leaves, copied in every leaf they overlap.
+ * A loose tree keeps each entry once, in the deepest node whose loose bounds, twice the size of its bounds,
+ * contain it: interior nodes hold entries too, and the queries walk the loose bounds.
+ * The tree is linear: it is built level by level from all the entries at once, a counting pass sizing
+ * the range of each child before the entries are scattered, so that the entries of a node are contiguous.
  */
 class QuadTree {
 public:
-	CustomlyAllocatedVector<QuadNode> Nodes; /**< Vector of quadtree nodes. */
+	CustomlyAllocatedVector<QuadNode> Nodes; /**< Vector of quadtree nodes, grown to the deepest subdivided level. */
+	CustomlyAllocatedVector<QuadTreeItem> Items; /**< Entries of every node, node after node. */
 
 private:
-	static constexpr int MAX_COL_NBR = 16; /**< Maximum number of colliders in a quadtree node. */
-	static constexpr int MAX_DEPTH = 5; /**< Maximum depth of the quadtree. */
-	int _nodeIndex = 1; /**< The index of the current node in the quadtree. */
-	Allocator& _alloc; /**< The allocator for memory allocation.*/
+	static constexpr int MAX_COL_NBR = 16; /**< Default maximum number of colliders in a quadtree node. */
+	static constexpr int MAX_DEPTH = 5; /**< Default maximum depth of the quadtree. */
+	static constexpr float QUANTIZED_MAX = 65535.f; /**< Quantized coordinate of the maximum of a frame. */
+	static constexpr int MAX_DEPTH_LIMIT = 8; /**< Highest depth limit, the implicit indices of a tree this deep already span 87381 nodes. */
+
+	int _maxColliders = MAX_COL_NBR; /**< Number of entries over which a node is subdivided. */
+	int _maxDepth = MAX_DEPTH; /**< Depth at which the nodes stop being subdivided. */
+	QuadTreeStats _stats; /**< Shape of the last built tree. */
+	const ColliderRefAabb* _entries = nullptr; /**< The entries of the last build, owned by the caller. */
+	bool _isLoose = false; /**< Flag indicating if the entries are stored once, in loose nodes. */
+	std::vector<std::uint32_t> _levelEntries; /**< Entries of the nodes of the level being built, as indices in the built entries. */
+	std::vector<std::uint32_t> _nextLevelEntries; /**< Entries of the nodes of the next level. */
+	std::vector<std::uint32_t> _levelNodes; /**< Nodes of the level being built, their item range pointing in the level entries. */
+	std::vector<std::uint32_t> _nextLevelNodes; /**< Nodes of the next level. */
+	std::vector<std::uint8_t> _childMasks; /**< Children of each entry of the node being split, one bit per child. */
 public:
 	/**
 	 * @brief Constructor for QuadTree, allocating memory using a specified allocator.
 	 * @param alloc The allocator for memory allocation.
+	 * @note Only the root is allocated, the nodes and items grow with the first builds and are kept after.
 	 */
 	QuadTree(Allocator& alloc) noexcept;
 
 	/**
-	 * @brief Set up the root of the quadtree with the specified bounds.
-	 * @param bounds The bounds of the root node.
+	 * @brief Build the quadtree from its entries.
+	 * @param bounds The bounds of the root node, containing every entry.
+	 * @param entries The collider references with an AABB to insert.
+	 * @note A node is subdivided when more entries than the collider limit reach it, like a tree filled one entry at a time,
+	 * and keeps the order of the entries. The items point in the entries, which must outlive the tree or its next build.
 	 */
-	void SetUpRoot(const RectangleF& bounds) noexcept;
+	void Build(const RectangleF& bounds, const std::vector<ColliderRefAabb>& entries) noexcept;
 
 	/**
-	 * @brief Insert a collider reference with an associated AABB into the quadtree.
-	 * @param node The node to insert into.
-	 * @param colliderRefAabb The collider reference with an AABB to insert.
+	 * @brief Get the index of the first of the 4 children of a node.
 	 */
-	void Insert(QuadNode& node, const ColliderRefAabb& colliderRefAabb) noexcept;
+	[[nodiscard]] static constexpr std::size_t FirstChild(const std::size_t nodeIndex) noexcept { return 4 * nodeIndex + 1; }
+
+	/**
+	 * @brief Get the entries of a node.
+	 */
+	[[nodiscard]] QuadNodeItems GetItems(const QuadNode& node) const noexcept
+	{
+		const QuadTreeItem* first = Items.data() + node.FirstItem;
+		return { first, first + node.ItemCount, _entries, { 0, 0, 0xFFFF, 0xFFFF } };
+	}
+
+	/**
+	 * @brief Get the entries of a node whose quantized bounds overlap an area.
+	 */
+	[[nodiscard]] QuadNodeItems GetItems(const QuadNode& node, const RectangleF& aabb) const noexcept
+	{
+		const QuadTreeItem* first = Items.data() + node.FirstItem;
+		if (!Intersect(node.ItemBounds, aabb))
+		{
+			return { first, first, _entries, {} };
+		}
+		return { first, first + node.ItemCount, _entries, Quantize(aabb, node.ItemBounds) };
+	}
+
+	/**
+	 * @brief Quantize bounds in a frame, rounding outwards and clamping to the frame.
+	 * @param aabb The bounds.
+	 * @param frame The frame, mapped to [0, 65535] on both axes.
+	 */
+	[[nodiscard]] static QuantizedAabb Quantize(const RectangleF& aabb, const RectangleF& frame) noexcept;
+
+	/**
+	 * @brief Set the subdivision limits, from the next Build.
+	 * @param maxColliders The number of entries over which a node is subdivided, at least 1.
+	 * @param maxDepth The depth at which the nodes stop being subdivided, clamped to [0, 8].
+	 */
+	void SetLimits(int maxColliders, int maxDepth) noexcept;
+
+	/**
+	 * @brief Get the number of entries over which a node is subdivided.
+	 */
+	[[nodiscard]] int GetMaxColliders() const noexcept { return _maxColliders; }
+
+	/**
+	 * @brief Get the depth at which the nodes stop being subdivided.
+	 */
+	[[nodiscard]] int GetMaxDepth() const noexcept { return _maxDepth; }
+
+	/**
+	 * @brief Get the shape of the last built tree.
+	 */
+	[[nodiscard]] const QuadTreeStats& GetStats() const noexcept { return _stats; }
+
+	/**
+	 * @brief Set if the tree is loose, from the next Build.
+	 * @param isLoose true to store each entry once in loose nodes, false to copy it in every leaf it overlaps.
+	 */
+	void SetLoose(bool isLoose) noexcept { _isLoose = isLoose; }
+
+	/**
+	 * @brief Check if the tree is loose.
+	 */
+	[[nodiscard]] bool IsLoose() const noexcept { return _isLoose; }
 private:
 	/**
-	 * @brief Subdivide a quadtree node into smaller child nodes.
-	 * @param node The node to subdivide.
+	 * @brief Store the entries of a node of the level being built, or subdivide it and hand them to its children.
+	 * @param nodeIndex The index of the node.
+	 * @param entries The entries of the tree.
+	 */
+	void SplitNode(std::uint32_t nodeIndex, const std::vector<ColliderRefAabb>& entries) noexcept;
+
+	/**
+	 * @brief Compute the item bounds of a node and quantize its items in them.
+	 * @param nodeIndex The index of the node, whose items only have their entry index set.
+	 */
+	void QuantizeItems(std::size_t nodeIndex) noexcept;
+
+	/**
+	 * @brief Get the children of a node an AABB goes to.
+	 * @param nodeIndex The index of the node, it must have children.
+	 * @param aabb The AABB.
+	 * @return One bit per child: the overlapped children in a tight tree, the loose child containing the AABB
+	 * in a loose one, 0 if the AABB stays in the node.
+	 */
+	[[nodiscard]] std::uint8_t GetChildMask(std::size_t nodeIndex, const RectangleF& aabb) const noexcept;
+
+	/**
+	 * @brief Get the bounds of a node as seen by the queries, grown by half their size on each side in a loose tree.
+	 */
+	[[nodiscard]] RectangleF GetLooseBounds(const RectangleF& bounds) const noexcept;
+
+	/**
+	 * @brief Subdivide a quadtree node into smaller child nodes, growing the node storage to hold them.
+	 * @param nodeIndex The index of the node to subdivide.
 	 */
-	void SubdivideNode(QuadNode& node) noexcept;
+	void SubdivideNode(std::size_t nodeIndex) noexcept;
 };
\ No newline at end of file
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "QuadTree.h"
+
+#include <cstddef>
+
+/**
+ * @brief Adaptive subdivision limits of a QuadTree, searched step after step to lower the cost of the broadphase.
+ * @note The cost of a step is its number of pair tests plus the number of entries stored in the tree,
+ * so that fewer tests bought with more copies of each collider are not taken as a gain.
+ * The current limits are measured over a window of steps, then a neighbour one move away: doubling or halving
+ * the collider limit, deepening or shortening the tree. The neighbour is kept if it is clearly cheaper.
+ * Both measures are counts and not timings, so that a simulation tunes its tree the same way on every run.
+ */
+class QuadTreeTuner
+{
+public:
+	static constexpr int MIN_COLLIDERS = 4; /**< Lowest collider limit tried. */
+	static constexpr int MAX_COLLIDERS = 256; /**< Highest collider limit tried. */
+	static constexpr int MIN_DEPTH = 2; /**< Lowest depth limit tried. */
+	static constexpr int MAX_DEPTH = 8; /**< Highest depth limit tried. */
+	static constexpr std::size_t WINDOW_STEPS = 8; /**< Number of steps measured for each limits. */
+	static constexpr double IMPROVEMENT = 0.95; /**< Cost ratio under which a neighbour replaces the current limits. */
+
+private:
+	static constexpr int MOVE_COUNT = 4; /**< Double the collider limit, halve it, deepen the tree, shorten it. */
+
+	int _maxColliders = 16; /**< Collider limit kept so far. */
+	int _maxDepth = 5; /**< Depth limit kept so far. */
+	int _move = 0; /**< The next move to try. */
+	bool _isTrial = false; /**< Flag indicating if the window measures a neighbour instead of the current limits. */
+	std::size_t _stepCount = 0; /**< Steps measured in the window. */
+	double _costSum = 0.0; /**< Sum of the costs of the steps of the window. */
+	double _cost = 0.0; /**< Mean cost of a step with the current limits, over their last window. */
+	std::size_t _keptMoves = 0; /**< Number of neighbours that replaced the current limits. */
+
+public:
+	/**
+	 * @brief Start the search again from the limits of a tree.
+	 * @param tree The tree to tune.
+	 */
+	void Reset(const QuadTree& tree) noexcept;
+
+	/**
+	 * @brief Record the cost of a step, and change the limits of the tree at the end of a window.
+	 * @param tree The tree built for the step.
+	 * @param pairTests The number of pair tests of the step.
+	 */
+	void Record(QuadTree& tree, std::size_t pairTests) noexcept;
+
+	/**
+	 * @brief Get the collider limit kept so far, the tree may be measuring a neighbour.
+	 */
+	[[nodiscard]] int GetMaxColliders() const noexcept { return _maxColliders; }
+
+	/**
+	 * @brief Get the depth limit kept so far, the tree may be measuring a neighbour.
+	 */
+	[[nodiscard]] int GetMaxDepth() const noexcept { return _maxDepth; }
+
+	/**
+	 * @brief Get the mean cost of a step with the limits kept so far, 0 before the first window.
+	 */
+	[[nodiscard]] double GetCost() const noexcept { return _cost; }
+
+	/**
+	 * @brief Get the number of neighbours that replaced the limits since the last reset.
+	 */
+	[[nodiscard]] std::size_t GetKeptMoves() const noexcept { return _keptMoves; }
+
+private:
+	/**
+	 * @brief Get the limits one move away from the current ones.
+	 * @param move The move.
+	 * @param maxColliders The collider limit of the neighbour.
+	 * @param maxDepth The depth limit of the neighbour.
+	 * @return false if the move leaves the searched limits.
+	 */
+	[[nodiscard]] bool GetNeighbour(int move, int& maxColliders, int& maxDepth) const noexcept;
+};
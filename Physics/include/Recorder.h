@@ -0,0 +1,163 @@
+#pragma once
+
+#include "World.h"
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/**
+ * @file Recorder.h
+ * @brief Recording of the world steps in a replay file.
+ * @note A replay file is a RecordingHeader followed by the frames, each a FrameHeader and its payload, then the index
+ * of the keyframes. A keyframe payload is a World::Snapshot, a delta payload lists the bodies whose quantized
+ * position or velocity changed since the previous frame. The index and the counts of the header are written on close,
+ * a file whose recording was interrupted is still read by scanning its frames.
+ */
+
+/**
+ * @brief Header at the start of a replay file.
+ */
+struct RecordingHeader
+{
+	std::uint32_t Magic; /**< Identifies a replay file. */
+	std::uint32_t Version; /**< Version of the file layout. */
+	std::uint32_t KeyframeInterval; /**< Number of frames between two keyframes. */
+	std::uint32_t KeyframeCount; /**< Number of keyframes in the index, 0 until the recording is closed. */
+	float PositionQuantum; /**< Precision of the positions of the delta frames. */
+	float VelocityQuantum; /**< Precision of the velocities of the delta frames. */
+	std::uint64_t FrameCount; /**< Number of frames, 0 until the recording is closed. */
+	std::uint64_t IndexOffset; /**< Offset of the keyframe index in the file, 0 until the recording is closed. */
+};
+
+/**
+ * @brief Kind of a recorded frame.
+ */
+enum class FrameType : std::uint32_t { KEYFRAME, DELTA };
+
+/**
+ * @brief Header of each recorded frame.
+ */
+struct FrameHeader
+{
+	FrameType Type; /**< Keyframe or delta frame. */
+	std::uint32_t BodyCount; /**< Number of body slots of the world. */
+	std::uint64_t StateHash; /**< World::StateHash of the recorded world, exact even for delta frames. */
+	std::uint64_t PayloadSize; /**< Size of the payload following the header. */
+};
+
+/**
+ * @brief Entry of the keyframe index at the end of a replay file.
+ */
+struct KeyframeEntry
+{
+	std::uint64_t Frame; /**< Number of the frame. */
+	std::uint64_t Offset; /**< Offset of its FrameHeader in the file. */
+};
+
+static constexpr std::uint32_t RECORDING_MAGIC = 0x43525742; /**< "BWRC" read as little endian. */
+static constexpr std::uint32_t RECORDING_VERSION = 1; /**< Version of the replay file layout. */
+
+/**
+ * @brief Map a signed value to an unsigned one, small magnitudes giving small values.
+ */
+[[nodiscard]] constexpr std::uint64_t ZigZagEncode(const std::int64_t value) noexcept
+{
+	return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+}
+
+/**
+ * @brief Inverse of ZigZagEncode.
+ */
+[[nodiscard]] constexpr std::int64_t ZigZagDecode(const std::uint64_t value) noexcept
+{
+	return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+}
+
+using QuantizedBody = std::array<std::int64_t, 4>; /**< Quantized position and velocity of a body. */
+
+/**
+ * @brief Quantize the position and velocity of a body.
+ * @param body The body.
+ * @param positionQuantum The precision of the position.
+ * @param velocityQuantum The precision of the velocity.
+ */
+[[nodiscard]] QuantizedBody Quantize(const Body& body, float positionQuantum, float velocityQuantum) noexcept;
+
+/**
+ * @brief Listener writing every step of a world in a replay file.
+ * @note Set it with World::SetUpdateListener once opened. Keyframes are written every keyframe interval and whenever
+ * the number of bodies or colliders changes, other changes than the positions and velocities, like a new shape,
+ * only appear in the replay at the next keyframe unless one is requested.
+ */
+class Recorder final : public UpdateListener
+{
+public:
+	static constexpr std::uint32_t DEFAULT_KEYFRAME_INTERVAL = 120; /**< Two seconds at 60 Hz. */
+	static constexpr float DEFAULT_POSITION_QUANTUM = 1.f / 256.f; /**< Far under a pixel. */
+	static constexpr float DEFAULT_VELOCITY_QUANTUM = 1.f / 64.f; /**< Far under a pixel per second. */
+
+private:
+	std::FILE* _file = nullptr; /**< The replay file being written. */
+	RecordingHeader _header{}; /**< Header of the file, rewritten on close. */
+	std::vector<KeyframeEntry> _keyframes; /**< Index of the keyframes written. */
+	std::uint64_t _offset = 0; /**< Offset of the next frame in the file. */
+
+	std::vector<QuantizedBody> _quantizedBodies; /**< Quantized state of the previous frame, the base of the deltas. */
+	std::vector<std::uint8_t> _payload; /**< Payload of the current frame, reused from frame to frame. */
+	std::size_t _colliderCount = 0; /**< Number of collider slots at the previous frame. */
+
+	bool _isKeyframeRequested = false; /**< Flag forcing a keyframe at the next frame. */
+	bool _isFailed = false; /**< Flag set when a write failed, reported on close. */
+
+public:
+	Recorder() noexcept = default;
+	~Recorder() noexcept override;
+
+	Recorder(const Recorder&) = delete;
+	Recorder& operator=(const Recorder&) = delete;
+
+	/**
+	 * @brief Start a recording, closing the previous one.
+	 * @param path The path of the replay file, overwritten.
+	 * @param keyframeInterval The number of frames between two keyframes, bounding the cost of a seek.
+	 * @param positionQuantum The precision of the positions of the delta frames.
+	 * @param velocityQuantum The precision of the velocities of the delta frames.
+	 * @throws std::runtime_error if the file cannot be created.
+	 */
+	void Open(const std::string& path, std::uint32_t keyframeInterval = DEFAULT_KEYFRAME_INTERVAL,
+		float positionQuantum = DEFAULT_POSITION_QUANTUM, float velocityQuantum = DEFAULT_VELOCITY_QUANTUM);
+
+	/**
+	 * @brief Write the keyframe index and close the file.
+	 * @throws std::runtime_error if a write of the recording failed.
+	 */
+	void Close();
+
+	/**
+	 * @brief Write the next frame as a keyframe, after a change the deltas do not cover.
+	 */
+	void RequestKeyframe() noexcept { _isKeyframeRequested = true; }
+
+	/**
+	 * @brief Record the state of the world as the next frame.
+	 * @param world The stepped world.
+	 */
+	void OnUpdate(const World& world) noexcept override;
+
+	[[nodiscard]] bool IsOpen() const noexcept { return _file != nullptr; }
+	[[nodiscard]] std::uint64_t GetFrameCount() const noexcept { return _header.FrameCount; }
+
+private:
+	/**
+	 * @brief Write the payload of the current frame, with its header.
+	 */
+	void WriteFrame(FrameType type, std::uint32_t bodyCount, std::uint64_t stateHash) noexcept;
+
+	/**
+	 * @brief Append an unsigned value to the payload, 7 bits per byte.
+	 */
+	void WriteVarint(std::uint64_t value) noexcept;
+};
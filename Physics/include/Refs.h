@@ -1,38 +1,77 @@
 #pragma once
 
-#include "cstddef"
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+#ifndef PHYSICS_HANDLE_INDEX_BITS
+#define PHYSICS_HANDLE_INDEX_BITS 24 /**< Bits of the index of a handle, the remaining ones of 32 hold its generation. */
+#endif
+
+static_assert(PHYSICS_HANDLE_INDEX_BITS > 0 && PHYSICS_HANDLE_INDEX_BITS < 32, "A handle needs bits for its index and its generation");
+
 /**
- * @brief Represents a reference to a body in the world.
- * @note It consists of an index and a generation index.
+ * @brief Generational reference packed in 32 bits: the index of a slot in the low bits, its generation in the high ones.
+ * @tparam Tag The referenced type, so that body and collider references do not mix.
+ * @note The generation of a slot is increased when its object is destroyed, so a stale reference no longer
+ * matches and is detected in O(1). Generations wrap around after 2^(32 - index bits) destructions of a slot.
  */
-struct BodyRef {
-	std::size_t Index;
-	std::size_t GenIndex;
+template<typename Tag>
+struct Handle
+{
+	static constexpr std::uint32_t INDEX_BITS = PHYSICS_HANDLE_INDEX_BITS; /**< Bits of the index. */
+	static constexpr std::uint32_t INDEX_MASK = (1u << INDEX_BITS) - 1u; /**< Mask of the index bits. */
+	static constexpr std::uint32_t GEN_MASK = ~INDEX_MASK >> INDEX_BITS; /**< Mask of a generation, before it is shifted. */
+	static constexpr std::size_t MAX_COUNT = std::size_t{ INDEX_MASK } + 1; /**< Number of slots a handle can index. */
+
+	std::uint32_t Value = 0; /**< The packed index and generation. */
+
+	constexpr Handle() noexcept = default;
 
 	/**
-	 * @brief Check if two BodyRef instances are equal.
-	 * @param other The BodyRef to compare with.
-	 * @return true if the _bodyRefs are equal, false otherwise.
+	 * @brief Constructor for Handle.
+	 * @param index The index of the slot, under MAX_COUNT, the world never grows past it.
+	 * @param genIndex The generation of the slot, wrapped to its bits.
 	 */
-	constexpr bool operator==(const BodyRef& other) const {
-		return (Index == other.Index) && (GenIndex == other.GenIndex);
+	constexpr Handle(const std::size_t index, const std::size_t genIndex) noexcept :
+		Value(static_cast<std::uint32_t>(index & INDEX_MASK) | static_cast<std::uint32_t>(genIndex & GEN_MASK) << INDEX_BITS)
+	{
+		assert(index < MAX_COUNT && "A handle index would alias another slot");
 	}
+
+	/**
+	 * @brief Get the index of the slot.
+	 */
+	[[nodiscard]] constexpr std::size_t Index() const noexcept { return Value & INDEX_MASK; }
+
+	/**
+	 * @brief Get the generation of the slot when the reference was made.
+	 */
+	[[nodiscard]] constexpr std::uint32_t GenIndex() const noexcept { return Value >> INDEX_BITS; }
+
+	/**
+	 * @brief Get the generation following another one, wrapping around.
+	 */
+	[[nodiscard]] static constexpr std::uint32_t NextGenIndex(const std::uint32_t genIndex) noexcept { return (genIndex + 1) & GEN_MASK; }
+
+	/**
+	 * @brief Check if two references are equal.
+	 * @param other The reference to compare with.
+	 * @return true if they reference the same slot with the same generation, false otherwise.
+	 */
+	constexpr bool operator==(const Handle& other) const noexcept { return Value == other.Value; }
+
+	constexpr bool operator!=(const Handle& other) const noexcept { return Value != other.Value; }
 };
 
+/**
+ * @brief Represents a reference to a body in the world.
+ */
+using BodyRef = Handle<struct BodyTag>;
+
 /**
  * @brief Represents a reference to a collider in the world.
- * @note It consists of an index and a generation index.
  */
-struct ColliderRef {
-	std::size_t Index;
-	std::size_t GenIndex;
+using ColliderRef = Handle<struct ColliderTag>;
 
-	/**
-	 * @brief Check if two ColliderRef instances are equal.
-	 * @param other The ColliderRef to compare with.
-	 * @return true if the ColliderRefs are equal, false otherwise.
-	 */
-	constexpr bool operator==(const ColliderRef& other) const {
-		return Index == other.Index && GenIndex == other.GenIndex;
-	}
-};
\ No newline at end of file
+static_assert(sizeof(BodyRef) == 4 && sizeof(ColliderRef) == 4, "References are packed in 32 bits");
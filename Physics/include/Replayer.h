@@ -0,0 +1,92 @@
+#pragma once
+
+#include "MappedFile.h"
+#include "Recorder.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Reader of the replay files written by a Recorder, restoring any recorded frame in a world.
+ * @note The file is memory mapped, a seek restores the closest keyframe before the frame then applies the deltas up
+ * to it, so it costs at most a keyframe interval of frames. Delta frames set the positions and velocities of the
+ * bodies to the quantized recording, keyframes restore the exact state.
+ */
+class Replayer
+{
+private:
+	MappedFile _file; /**< The mapped replay file. */
+	RecordingHeader _header{}; /**< Header of the file, with the counts found by scanning an unclosed recording. */
+	std::vector<KeyframeEntry> _keyframes; /**< Index of the keyframes. */
+
+	std::vector<QuantizedBody> _quantizedBodies; /**< Quantized state of the current frame, the base of the next delta. */
+	std::uint64_t _frame = 0; /**< Number of the frame restored last. */
+	std::uint64_t _nextOffset = 0; /**< Offset of the frame following the restored one, 0 before any restore. */
+	std::uint64_t _stateHash = 0; /**< Recorded state hash of the frame restored last. */
+
+public:
+	/**
+	 * @brief Map a replay file and read its keyframe index.
+	 * @param path The path of the replay file.
+	 * @throws std::runtime_error if the file cannot be mapped or is not a replay file of this version.
+	 */
+	void Open(const std::string& path);
+
+	/**
+	 * @brief Unmap the replay file.
+	 */
+	void Close() noexcept;
+
+	/**
+	 * @brief Restore a recorded frame in a world.
+	 * @param world The world, its state is replaced.
+	 * @param frame The number of the frame, from 0 to the frame count excluded.
+	 * @throws std::runtime_error if the frame is out of the recording or the file is corrupted.
+	 */
+	void Seek(World& world, std::uint64_t frame);
+
+	/**
+	 * @brief Restore the frame following the one restored last, the first one if none was.
+	 * @param world The world the previous frame was restored in.
+	 * @return false if the last frame had already been restored.
+	 * @throws std::runtime_error if the file is corrupted.
+	 */
+	bool Next(World& world);
+
+	[[nodiscard]] std::uint64_t GetFrameCount() const noexcept { return _header.FrameCount; }
+	[[nodiscard]] const std::vector<KeyframeEntry>& GetKeyframes() const noexcept { return _keyframes; }
+	[[nodiscard]] std::uint32_t GetKeyframeInterval() const noexcept { return _header.KeyframeInterval; }
+	[[nodiscard]] std::size_t GetFileSize() const noexcept { return _file.Size(); }
+
+	/**
+	 * @brief Get the number of the frame restored last.
+	 */
+	[[nodiscard]] std::uint64_t GetFrame() const noexcept { return _frame; }
+
+	/**
+	 * @brief Get the World::StateHash recorded with the frame restored last, to compare with a live simulation.
+	 */
+	[[nodiscard]] std::uint64_t GetRecordedStateHash() const noexcept { return _stateHash; }
+
+	/**
+	 * @brief Check if the frame restored last is a keyframe, restoring the exact recorded state.
+	 */
+	[[nodiscard]] bool IsKeyframe() const noexcept;
+
+private:
+	/**
+	 * @brief Read the header of the frame at an offset, checking that its payload is in the file.
+	 */
+	[[nodiscard]] FrameHeader ReadFrameHeader(std::uint64_t offset) const;
+
+	/**
+	 * @brief Restore the frame at an offset, which must follow the frame restored last unless it is a keyframe.
+	 */
+	void RestoreFrame(World& world, std::uint64_t frame, std::uint64_t offset);
+
+	/**
+	 * @brief Find the frames of a recording interrupted before it was closed.
+	 */
+	void ScanFrames();
+};
@@ -2,13 +2,18 @@
 
 #include <DirectXMath.h>
 #include "Utility.h"
+#include <array>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <utility>
 #include <vector>
 
 using namespace DirectX;
 
 enum class ShapeType
 {
-	Circle, Rectangle, Polygon, None
+	Circle, Rectangle, Polygon, OrientedRectangle, None
 };
 
 template <typename T>
@@ -132,6 +137,10 @@ public:
 using RectangleF = Rectangle<float>;
 using RectangleI = Rectangle<int>;
 
+/**
+ * @brief Convex polygon whose vertices are immutable and shared by its copies
+ * @note Copying a polygon only copies a pointer, so colliders made from the same prototype share one vertex array.
+ */
 template <typename T>
 class Polygon
 {
@@ -140,27 +149,62 @@ public:
 	 * @brief Construct a new Polygon object
 	 * @param vertices the vertices of the polygon
 	 */
-	constexpr explicit Polygon(std::vector<XMVECTOR> vertices) noexcept : _vertices(vertices) {}
+	explicit Polygon(std::vector<XMVECTOR> vertices) noexcept :
+		_vertices(std::make_shared<const std::vector<XMVECTOR>>(std::move(vertices))) {}
 
 private:
-	std::vector<XMVECTOR> _vertices;
+	std::shared_ptr<const std::vector<XMVECTOR>> _vertices;
 
 public:
-	[[nodiscard]] constexpr std::vector<XMVECTOR> Vertices() const noexcept { return _vertices; }
-	[[nodiscard]] constexpr int VerticesCount() const noexcept { return _vertices.size(); }
+	[[nodiscard]] const std::vector<XMVECTOR>& Vertices() const noexcept { return *_vertices; }
+	[[nodiscard]] int VerticesCount() const noexcept { return _vertices->size(); }
 
-	void SetVertices(std::vector<XMVECTOR> vertices) noexcept { _vertices = vertices; }
+	/**
+	 * @brief Check if two polygons share the same vertex array
+	 */
+	[[nodiscard]] bool SharesVertices(const Polygon<T>& other) const noexcept { return _vertices == other._vertices; }
+
+	void SetVertices(std::vector<XMVECTOR> vertices) noexcept
+	{
+		_vertices = std::make_shared<const std::vector<XMVECTOR>>(std::move(vertices));
+	}
+
+	/**
+	 * @brief Check if the polygon contains a point, by counting the edges crossed by a ray from the point
+	 * @param point the point to check
+	 * @return true if the point is inside the polygon, false otherwise
+	 */
+	[[nodiscard]] bool Contains(XMVECTOR point) const
+	{
+		const auto& vertices = *_vertices;
+		const float x = XMVectorGetX(point);
+		const float y = XMVectorGetY(point);
+		bool isInside = false;
+
+		for (std::size_t i = 0, j = vertices.size() - 1; i < vertices.size(); j = i++)
+		{
+			const float xi = XMVectorGetX(vertices[i]), yi = XMVectorGetY(vertices[i]);
+			const float xj = XMVectorGetX(vertices[j]), yj = XMVectorGetY(vertices[j]);
+
+			if ((yi > y) != (yj > y) && x < (xj - xi) * (y - yi) / (yj - yi) + xi)
+			{
+				isInside = !isInside;
+			}
+		}
+
+		return isInside;
+	}
 
 	[[nodiscard]] constexpr XMVECTOR Center() const noexcept
 	{
 		XMVECTOR center = XMVECTOR::Zero();
 
-		for (const auto& vertex : _vertices)
+		for (const auto& vertex : *_vertices)
 		{
 			center += vertex;
 		}
 
-		return center / _vertices.size();
+		return center / _vertices->size();
 	}
 
 	[[nodiscard]] constexpr XMVECTOR Size() const noexcept
@@ -168,7 +212,7 @@ public:
 		XMVECTOR minBound = XMVECTOR::Zero();
 		XMVECTOR maxBound = XMVECTOR::Zero();
 
-		for (const auto& vertex : _vertices)
+		for (const auto& vertex : *_vertices)
 		{
 			XMVectorGetX(minBound) = Min(XMVectorGetX(minBound), vertex.X);
 			XMVectorGetY(minBound) = Min(XMVectorGetY(minBound), vertex.Y);
@@ -182,7 +226,7 @@ public:
 
 	[[nodiscard]] constexpr Polygon<T> operator+(const XMVECTOR& vec) const noexcept
 	{
-		std::vector<XMVECTOR> vertices = _vertices;
+		std::vector<XMVECTOR> vertices = *_vertices;
 
 		for (auto& vertex : vertices)
 		{
@@ -196,6 +240,118 @@ public:
 using PolygonF = Polygon<float>;
 using PolygonI = Polygon<int>;
 
+/**
+ * @brief Rectangle rotated around its center, its rotation is kept as a cosine and a sine so that no test computes them
+ */
+template <typename T>
+class OrientedRectangle
+{
+public:
+	/**
+	 * @brief Construct a new OrientedRectangle object
+	 * @param center the center of the rectangle
+	 * @param halfSize the half size of the rectangle along its own axes
+	 * @param cos the cosine of the rotation
+	 * @param sin the sine of the rotation
+	 */
+	constexpr OrientedRectangle(XMVECTOR center, XMVECTOR halfSize, T cos, T sin) noexcept :
+		_center(center), _halfSize(XMVectorAbs(halfSize)), _cos(cos), _sin(sin) {}
+
+	/**
+	 * @brief Construct a new OrientedRectangle object rotated by an angle
+	 * @param center the center of the rectangle
+	 * @param halfSize the half size of the rectangle along its own axes
+	 * @param angle the rotation in radians, counterclockwise
+	 */
+	OrientedRectangle(XMVECTOR center, XMVECTOR halfSize, T angle) noexcept :
+		OrientedRectangle(center, halfSize, std::cos(angle), std::sin(angle)) {}
+
+private:
+	XMVECTOR _center = XMVectorZero();
+	XMVECTOR _halfSize = XMVectorZero();
+	T _cos = 1;
+	T _sin = 0;
+
+public:
+	[[nodiscard]] constexpr XMVECTOR Center() const noexcept { return _center; }
+	[[nodiscard]] constexpr XMVECTOR HalfSize() const noexcept { return _halfSize; }
+	[[nodiscard]] constexpr T Cos() const noexcept { return _cos; }
+	[[nodiscard]] constexpr T Sin() const noexcept { return _sin; }
+
+	/**
+	 * @brief Get the axis of the width of the rectangle
+	 */
+	[[nodiscard]] XMVECTOR AxisX() const noexcept { return XMVectorSet(_cos, _sin, 0, 0); }
+
+	/**
+	 * @brief Get the axis of the height of the rectangle
+	 */
+	[[nodiscard]] XMVECTOR AxisY() const noexcept { return XMVectorSet(-_sin, _cos, 0, 0); }
+
+	void SetCenter(XMVECTOR center) noexcept { _center = center; }
+	void SetHalfSize(XMVECTOR halfSize) noexcept { _halfSize = XMVectorAbs(halfSize); }
+	void SetRotation(T angle) noexcept
+	{
+		_cos = std::cos(angle);
+		_sin = std::sin(angle);
+	}
+
+	/**
+	 * @brief Check if the rectangle contains a point, by projecting it on the axes of the rectangle
+	 * @param point the point to check
+	 * @return true if the point is inside the rectangle, false otherwise
+	 */
+	[[nodiscard]] bool Contains(XMVECTOR point) const
+	{
+		const T dx = XMVectorGetX(point) - XMVectorGetX(_center);
+		const T dy = XMVectorGetY(point) - XMVectorGetY(_center);
+
+		return Abs(dx * _cos + dy * _sin) <= XMVectorGetX(_halfSize) && Abs(dy * _cos - dx * _sin) <= XMVectorGetY(_halfSize);
+	}
+
+	/**
+	 * @brief Get the half size of the axis aligned bounding box of the rectangle
+	 */
+	[[nodiscard]] XMVECTOR Extents() const noexcept
+	{
+		const T absCos = Abs(_cos), absSin = Abs(_sin);
+		const T halfX = XMVectorGetX(_halfSize), halfY = XMVectorGetY(_halfSize);
+
+		return XMVectorSet(absCos * halfX + absSin * halfY, absSin * halfX + absCos * halfY, 0, 0);
+	}
+
+	/**
+	 * @brief Get the corners of the rectangle, counterclockwise
+	 */
+	[[nodiscard]] std::array<XMVECTOR, 4> Corners() const noexcept
+	{
+		const auto axisX = XMVectorScale(AxisX(), XMVectorGetX(_halfSize));
+		const auto axisY = XMVectorScale(AxisY(), XMVectorGetY(_halfSize));
+
+		return {
+			XMVectorSubtract(XMVectorSubtract(_center, axisX), axisY),
+			XMVectorSubtract(XMVectorAdd(_center, axisX), axisY),
+			XMVectorAdd(XMVectorAdd(_center, axisX), axisY),
+			XMVectorAdd(XMVectorSubtract(_center, axisX), axisY)
+		};
+	}
+
+	[[nodiscard]] constexpr OrientedRectangle<T> operator+(const XMVECTOR& vec) const noexcept
+	{
+		return OrientedRectangle<T>(XMVectorAdd(_center, vec), _halfSize, _cos, _sin);
+	}
+
+	/**
+	 * @brief Get the same area as a rectangle with no rotation
+	 */
+	[[nodiscard]] static constexpr OrientedRectangle<T> FromRectangle(const Rectangle<T>& rectangle) noexcept
+	{
+		return OrientedRectangle<T>(rectangle.Center(), rectangle.HalfSize(), 1, 0);
+	}
+};
+
+using OrientedRectangleF = OrientedRectangle<float>;
+
 // Intersect functions
 
 template<typename T>
@@ -409,3 +565,281 @@ template <typename T>
 {
 	return Intersect(polygon, rectangle);
 }
+
+// Separating axis tests of the oriented rectangles, a rotated pair only has the 4 axes of the two rectangles
+// The penetration functions give the smallest move of the first shape out of the second, the normal goes from the second to the first
+
+template <typename T>
+[[nodiscard]] bool Penetration(const OrientedRectangle<T> rectangle1, const OrientedRectangle<T> rectangle2, XMVECTOR& normal, T& depth) noexcept
+{
+	const T dx = XMVectorGetX(rectangle1.Center()) - XMVectorGetX(rectangle2.Center());
+	const T dy = XMVectorGetY(rectangle1.Center()) - XMVectorGetY(rectangle2.Center());
+	const T half1X = XMVectorGetX(rectangle1.HalfSize()), half1Y = XMVectorGetY(rectangle1.HalfSize());
+	const T half2X = XMVectorGetX(rectangle2.HalfSize()), half2Y = XMVectorGetY(rectangle2.HalfSize());
+
+	// The axes of one rectangle seen from the other only depend on the rotation between them
+	const T relativeCos = Abs(rectangle1.Cos() * rectangle2.Cos() + rectangle1.Sin() * rectangle2.Sin());
+	const T relativeSin = Abs(rectangle1.Cos() * rectangle2.Sin() - rectangle1.Sin() * rectangle2.Cos());
+
+	const std::array<XMVECTOR, 4> axes = { rectangle1.AxisX(), rectangle1.AxisY(), rectangle2.AxisX(), rectangle2.AxisY() };
+	const std::array<T, 4> radii = {
+		half1X + half2X * relativeCos + half2Y * relativeSin,
+		half1Y + half2X * relativeSin + half2Y * relativeCos,
+		half1X * relativeCos + half1Y * relativeSin + half2X,
+		half1X * relativeSin + half1Y * relativeCos + half2Y
+	};
+
+	depth = std::numeric_limits<T>::max();
+	for (std::size_t i = 0; i < axes.size(); ++i)
+	{
+		const T distance = dx * XMVectorGetX(axes[i]) + dy * XMVectorGetY(axes[i]);
+		const T overlap = radii[i] - Abs(distance);
+		if (overlap < 0) return false;
+
+		if (overlap < depth)
+		{
+			depth = overlap;
+			normal = distance < 0 ? XMVectorNegate(axes[i]) : axes[i];
+		}
+	}
+
+	return true;
+}
+
+template <typename T>
+[[nodiscard]] bool Penetration(const Circle<T> circle, const OrientedRectangle<T> rectangle, XMVECTOR& normal, T& depth) noexcept
+{
+	// The center of the circle in the space of the rectangle
+	const T dx = XMVectorGetX(circle.Center()) - XMVectorGetX(rectangle.Center());
+	const T dy = XMVectorGetY(circle.Center()) - XMVectorGetY(rectangle.Center());
+	const T localX = dx * rectangle.Cos() + dy * rectangle.Sin();
+	const T localY = dy * rectangle.Cos() - dx * rectangle.Sin();
+	const T halfX = XMVectorGetX(rectangle.HalfSize()), halfY = XMVectorGetY(rectangle.HalfSize());
+
+	const T gapX = localX - Clamp(localX, -halfX, halfX);
+	const T gapY = localY - Clamp(localY, -halfY, halfY);
+	const T squaredGap = gapX * gapX + gapY * gapY;
+	if (squaredGap > circle.Radius() * circle.Radius()) return false;
+
+	if (squaredGap > 0)
+	{
+		const T gap = std::sqrt(squaredGap);
+		depth = circle.Radius() - gap;
+		normal = XMVectorAdd(XMVectorScale(rectangle.AxisX(), gapX / gap), XMVectorScale(rectangle.AxisY(), gapY / gap));
+		return true;
+	}
+
+	// A center inside the rectangle leaves by the closest side
+	const T exitX = halfX - Abs(localX);
+	const T exitY = halfY - Abs(localY);
+	if (exitX < exitY)
+	{
+		depth = circle.Radius() + exitX;
+		normal = localX < 0 ? XMVectorNegate(rectangle.AxisX()) : rectangle.AxisX();
+	}
+	else
+	{
+		depth = circle.Radius() + exitY;
+		normal = localY < 0 ? XMVectorNegate(rectangle.AxisY()) : rectangle.AxisY();
+	}
+	return true;
+}
+
+template <typename T>
+[[nodiscard]] bool Intersect(const OrientedRectangle<T> rectangle1, const OrientedRectangle<T> rectangle2) noexcept
+{
+	XMVECTOR normal;
+	T depth;
+	return Penetration(rectangle1, rectangle2, normal, depth);
+}
+
+template <typename T>
+[[nodiscard]] bool Intersect(const OrientedRectangle<T> orientedRectangle, const Rectangle<T> rectangle) noexcept
+{
+	return Intersect(orientedRectangle, OrientedRectangle<T>::FromRectangle(rectangle));
+}
+
+template <typename T>
+[[nodiscard]] bool Intersect(const Rectangle<T> rectangle, const OrientedRectangle<T> orientedRectangle) noexcept
+{
+	return Intersect(orientedRectangle, rectangle);
+}
+
+template <typename T>
+[[nodiscard]] bool Intersect(const Circle<T> circle, const OrientedRectangle<T> rectangle) noexcept
+{
+	const T dx = XMVectorGetX(circle.Center()) - XMVectorGetX(rectangle.Center());
+	const T dy = XMVectorGetY(circle.Center()) - XMVectorGetY(rectangle.Center());
+	const T localX = dx * rectangle.Cos() + dy * rectangle.Sin();
+	const T localY = dy * rectangle.Cos() - dx * rectangle.Sin();
+
+	const T gapX = localX - Clamp(localX, -XMVectorGetX(rectangle.HalfSize()), XMVectorGetX(rectangle.HalfSize()));
+	const T gapY = localY - Clamp(localY, -XMVectorGetY(rectangle.HalfSize()), XMVectorGetY(rectangle.HalfSize()));
+
+	return gapX * gapX + gapY * gapY <= circle.Radius() * circle.Radius();
+}
+
+template <typename T>
+[[nodiscard]] bool Intersect(const OrientedRectangle<T> rectangle, const Circle<T> circle) noexcept
+{
+	return Intersect(circle, rectangle);
+}
+
+template <typename T>
+[[nodiscard]] bool Intersect(const Polygon<T> polygon, const OrientedRectangle<T> rectangle) noexcept
+{
+	const auto corners = rectangle.Corners();
+	return Intersect(polygon, Polygon<T>(std::vector<XMVECTOR>(corners.begin(), corners.end())));
+}
+
+template <typename T>
+[[nodiscard]] bool Intersect(const OrientedRectangle<T> rectangle, const Polygon<T> polygon) noexcept
+{
+	return Intersect(polygon, rectangle);
+}
+
+// Ray cast functions
+// The direction must be normalized, a ray starting inside a shape hits it at distance 0 with a normal facing the ray
+
+template <typename T>
+[[nodiscard]] bool RayCast(const Circle<T> circle, XMVECTOR origin, XMVECTOR direction, T maxDistance, T& distance, XMVECTOR& normal) noexcept
+{
+	const auto delta = XMVectorSubtract(origin, circle.Center());
+	const T projection = XMVectorGetX(XMVector2Dot(delta, direction));
+	const T squaredGap = XMVectorGetX(XMVector2LengthSq(delta)) - circle.Radius() * circle.Radius();
+
+	if (squaredGap <= 0)
+	{
+		distance = 0;
+		normal = XMVectorNegate(direction);
+		return true;
+	}
+
+	// Outside and going away
+	if (projection > 0) return false;
+
+	const T discriminant = projection * projection - squaredGap;
+	if (discriminant < 0) return false;
+
+	distance = -projection - std::sqrt(discriminant);
+	if (distance > maxDistance) return false;
+
+	normal = XMVectorScale(XMVectorSubtract(XMVectorAdd(origin, XMVectorScale(direction, distance)), circle.Center()), 1 / circle.Radius());
+	return true;
+}
+
+template <typename T>
+[[nodiscard]] bool RayCast(const Rectangle<T> rectangle, XMVECTOR origin, XMVECTOR direction, T maxDistance, T& distance, XMVECTOR& normal) noexcept
+{
+	// Slab test, the ray is inside the rectangle between the last entry and the first exit of both axis
+	T enter = std::numeric_limits<T>::lowest();
+	T exit = std::numeric_limits<T>::max();
+	XMVECTOR enterNormal = XMVectorZero();
+
+	for (int axis = 0; axis < 2; ++axis)
+	{
+		const T start = XMVectorGetByIndex(origin, axis);
+		const T dir = XMVectorGetByIndex(direction, axis);
+		const T min = XMVectorGetByIndex(rectangle.MinBound(), axis);
+		const T max = XMVectorGetByIndex(rectangle.MaxBound(), axis);
+
+		if (Abs(dir) < std::numeric_limits<T>::epsilon())
+		{
+			if (start < min || start > max) return false;
+			continue;
+		}
+
+		T nearT = (min - start) / dir;
+		T farT = (max - start) / dir;
+		T side = -1;
+		if (nearT > farT)
+		{
+			std::swap(nearT, farT);
+			side = 1;
+		}
+
+		if (nearT > enter)
+		{
+			enter = nearT;
+			enterNormal = axis == 0 ? XMVectorSet(side, 0, 0, 0) : XMVectorSet(0, side, 0, 0);
+		}
+		exit = Min(exit, farT);
+	}
+
+	if (enter > exit || exit < 0 || enter > maxDistance) return false;
+
+	if (enter <= 0)
+	{
+		distance = 0;
+		normal = XMVectorNegate(direction);
+		return true;
+	}
+
+	distance = enter;
+	normal = enterNormal;
+	return true;
+}
+
+template <typename T>
+[[nodiscard]] bool RayCast(const Polygon<T>& polygon, XMVECTOR origin, XMVECTOR direction, T maxDistance, T& distance, XMVECTOR& normal) noexcept
+{
+	if (polygon.Contains(origin))
+	{
+		distance = 0;
+		normal = XMVectorNegate(direction);
+		return true;
+	}
+
+	const auto& vertices = polygon.Vertices();
+	T closest = maxDistance;
+	bool isHit = false;
+
+	for (std::size_t i = 0, j = vertices.size() - 1; i < vertices.size(); j = i++)
+	{
+		const auto edge = XMVectorSubtract(vertices[i], vertices[j]);
+		const auto toEdge = XMVectorSubtract(vertices[j], origin);
+
+		// Solve origin + t * direction = vertex j + s * edge with 2D cross products
+		const T denominator = XMVectorGetX(direction) * XMVectorGetY(edge) - XMVectorGetY(direction) * XMVectorGetX(edge);
+		if (Abs(denominator) < std::numeric_limits<T>::epsilon()) continue;
+
+		const T t = (XMVectorGetX(toEdge) * XMVectorGetY(edge) - XMVectorGetY(toEdge) * XMVectorGetX(edge)) / denominator;
+		const T s = (XMVectorGetX(toEdge) * XMVectorGetY(direction) - XMVectorGetY(toEdge) * XMVectorGetX(direction)) / denominator;
+
+		if (t < 0 || t > closest || s < 0 || s > 1) continue;
+
+		closest = t;
+		isHit = true;
+		normal = XMVector2Normalize(XMVectorSet(-XMVectorGetY(edge), XMVectorGetX(edge), 0, 0));
+		if (XMVectorGetX(XMVector2Dot(normal, direction)) > 0)
+		{
+			normal = XMVectorNegate(normal);
+		}
+	}
+
+	if (isHit)
+	{
+		distance = closest;
+	}
+	return isHit;
+}
+
+template <typename T>
+[[nodiscard]] bool RayCast(const OrientedRectangle<T> rectangle, XMVECTOR origin, XMVECTOR direction, T maxDistance, T& distance, XMVECTOR& normal) noexcept
+{
+	// The ray is turned into the space of the rectangle, where the slab test applies
+	const T dx = XMVectorGetX(origin) - XMVectorGetX(rectangle.Center());
+	const T dy = XMVectorGetY(origin) - XMVectorGetY(rectangle.Center());
+	const T dirX = XMVectorGetX(direction), dirY = XMVectorGetY(direction);
+	const auto localOrigin = XMVectorSet(dx * rectangle.Cos() + dy * rectangle.Sin(), dy * rectangle.Cos() - dx * rectangle.Sin(), 0, 0);
+	const auto localDirection = XMVectorSet(dirX * rectangle.Cos() + dirY * rectangle.Sin(), dirY * rectangle.Cos() - dirX * rectangle.Sin(), 0, 0);
+
+	XMVECTOR localNormal;
+	if (!RayCast(Rectangle<T>::FromCenter(XMVectorZero(), rectangle.HalfSize()), localOrigin, localDirection, maxDistance, distance, localNormal))
+	{
+		return false;
+	}
+
+	normal = XMVectorAdd(XMVectorScale(rectangle.AxisX(), XMVectorGetX(localNormal)), XMVectorScale(rectangle.AxisY(), XMVectorGetY(localNormal)));
+	return true;
+}
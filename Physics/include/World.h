@@ -1,13 +1,112 @@
 #pragma once
 
 #include "Body.h"
-#include "refs.h"
+#include "Refs.h"
 #include "Contact.h"
 #include "QuadTree.h"
+#include "QuadTreeTuner.h"
+#include "ThreadPool.h"
+#include <cstdint>
+#include <limits>
 #include <vector>
 #include <unordered_set>
 #include <stdexcept>
 
+/**
+ * @brief Time spent in each stage of the last World::Update, in milliseconds.
+ * @note The timings are only measured when profiling is enabled on the world, the counters are always filled.
+ */
+struct WorldProfile
+{
+	double IntegrateMs = 0.0; /**< Integration of forces and velocities. */
+	double QuadTreeBuildMs = 0.0; /**< Computation of the bounds and insertion in the QuadTree. */
+	double NarrowphaseMs = 0.0; /**< Exact overlap tests of the pairs found in the QuadTree leaves. */
+	double SolveMs = 0.0; /**< Contact resolution of the overlapping physical pairs. */
+
+	std::size_t PairTests = 0; /**< Number of pairs tested in the narrowphase. */
+	std::size_t Contacts = 0; /**< Number of contacts resolved. */
+	QuadTreeStats Tree; /**< Shape of the QuadTree of the last step and the limits it was built with. */
+};
+
+/**
+ * @brief A ray of the batched ray casts.
+ */
+struct Ray
+{
+	XMVECTOR Origin = XMVectorZero(); /**< Start of the ray. */
+	XMVECTOR Direction = XMVectorSet(1.f, 0.f, 0.f, 0.f); /**< Direction of the ray, normalized by the cast. */
+	float MaxDistance = std::numeric_limits<float>::max(); /**< Length of the ray. */
+};
+
+/**
+ * @brief Closest collider hit by a ray.
+ */
+struct RayCastHit
+{
+	ColliderRef ColRef{}; /**< The collider hit. */
+	XMVECTOR Point = XMVectorZero(); /**< Position of the hit. */
+	XMVECTOR Normal = XMVectorZero(); /**< Normal of the collider at the hit, facing the ray. */
+	float Distance = 0.f; /**< Distance of the hit along the ray. */
+	bool IsHit = false; /**< Flag indicating if the ray hit a collider, the other fields are only set if it did. */
+};
+
+/**
+ * @brief First collider met by a moving shape.
+ */
+struct ShapeCastHit
+{
+	ColliderRef ColRef{}; /**< The collider met. */
+	XMVECTOR Position = XMVectorZero(); /**< Position of the shape when it meets the collider. */
+	float Distance = 0.f; /**< Distance travelled by the shape. */
+	bool IsHit = false; /**< Flag indicating if the shape met a collider, the other fields are only set if it did. */
+};
+
+/**
+ * @brief Kinds of analytic force fields.
+ */
+enum class ForceFieldType { POINT, ZONE };
+
+/**
+ * @brief Analytic acceleration field, evaluated on every awake dynamic body by the integration.
+ */
+struct ForceField
+{
+	ForceFieldType Type = ForceFieldType::POINT; /**< Kind of field. */
+	XMVECTOR Position = XMVectorZero(); /**< Center of a point attractor. */
+	float Strength = 0.f; /**< Acceleration of a point attractor at a distance of 1, negative to repel. */
+	float Softening = 1.f; /**< Length added to the distance to a point attractor, avoiding infinite accelerations. */
+	float Radius = std::numeric_limits<float>::max(); /**< Distance beyond which a point attractor has no effect. */
+	XMVECTOR Acceleration = XMVectorZero(); /**< Constant acceleration inside a zone. */
+	RectangleF Zone{ XMVectorZero(), XMVectorZero() }; /**< Area of a zone. */
+};
+
+/**
+ * @brief A pair found by the broadphase, tested once every pair of the step is known in deterministic mode.
+ */
+struct PotentialPair
+{
+	const ColliderRefAabb* Entry1 = nullptr; /**< Entry of the collider with the lower index. */
+	const ColliderRefAabb* Entry2 = nullptr; /**< Entry of the collider with the higher index. */
+	std::uint64_t Key = 0; /**< Both collider indices, the lower one in the high bits, ordering the pairs. */
+};
+
+class World;
+
+/**
+ * @brief Interface notified after every simulation step of a world.
+ */
+class UpdateListener
+{
+public:
+	virtual ~UpdateListener() noexcept = default;
+
+	/**
+	 * @brief Called once the bodies have moved and the contacts have been resolved.
+	 * @param world The world that has been stepped.
+	 */
+	virtual void OnUpdate(const World& world) noexcept = 0;
+};
+
 /**
  * @brief Represents the physics world containing bodies and interactions.
  * @note This class manages the simulation of physics entities.
@@ -16,17 +115,68 @@
 class World {
 private:
 	std::vector<Body> _bodies; /**< A collection of all the bodies in the world. */
+	std::vector<std::uint32_t> _bodyColliderCounts; /**< Number of colliders attached to each body, so that destroying a body stops scanning the colliders once they are all found. */
 	std::vector<Collider> _colliders; /**< A collection of all the colliders in the world. */
+	std::vector<ColliderShape> _shapes; /**< Shape prototypes copied in the colliders created in bulk, polygons sharing their vertices. */
 
 	HeapAllocator _heapAlloc; /**< Allocator used to track memory usage. */
 	std::unordered_set<ColliderRefPair, ColliderRefPairHash, std::equal_to<ColliderRefPair>, StandardAllocator<ColliderRefPair>> _colRefPairs{ _heapAlloc }; /**< A set of colliderRef pairs for collision detection. */
 
 	ContactListener* _contactListener = nullptr; /**< A listener for contact events between colliders. */
+	UpdateListener* _updateListener = nullptr; /**< A listener notified after every step. */
+
+	XMVECTOR _gravity = XMVectorZero(); /**< Acceleration of every dynamic body. */
+	float _linearDamping = 0.f; /**< Rate at which the velocities decrease, per second. */
+	std::vector<ForceField> _forceFields; /**< Fields added to the gravity by the integration. */
+
+	RectangleF _bounds{ XMVectorZero(), XMVectorZero() }; /**< Area the dynamic bodies are kept in. */
+	bool _hasBounds = false; /**< Flag indicating if the bodies are kept in the bounds. */
+	std::vector<RectangleF> _bodyExtents; /**< Bounds of the colliders of each body relative to its position, at the last step. */
+
+	float _fixedDeltaTime = 1.f / 60.f; /**< Time step of the fixed step driver. */
+	int _maxSubSteps = 5; /**< Maximum number of fixed steps simulated in one frame. */
+	float _accumulator = 0.f; /**< Frame time not yet simulated by the fixed step driver. */
+
+	bool _isSleepingEnabled = false; /**< Flag indicating if resting bodies fall asleep. */
+	float _sleepVelocity = 10.f; /**< Speed under which a body is considered resting. */
+	float _timeToSleep = 0.5f; /**< Time an island must rest before falling asleep. */
+	std::vector<std::pair<std::size_t, std::size_t>> _contactBodyPairs; /**< Body indices of the physical contacts of the step, edges of the islands. */
+	std::vector<std::size_t> _islandParents; /**< Union-find parent of each body, the root identifies its island. */
+	std::vector<float> _islandSleepTimes; /**< Shortest resting time of each island, indexed by its root. */
+
+	std::vector<RectangleF> _colliderAabbs; /**< Bounds of each collider, kept while its body sleeps. */
+	std::vector<ColliderRefAabb> _quadTreeEntries; /**< Entries of the moving colliders, inserted once the root bounds are known. */
+
+	std::vector<ColliderRefAabb> _staticQuadTreeEntries; /**< Entries of the colliders of static bodies, in the static tree. */
+	std::vector<bool> _isInStaticTree; /**< Flag of each collider telling if it was in the last static tree. */
+	bool _isStaticTreeDirty = true; /**< Flag indicating if the static tree must be rebuilt before the next step. */
+
+	static constexpr int MAX_SWEEP_SUB_STEPS = 32; /**< Maximum number of positions tested along the move of a continuous body. */
+	static constexpr int SWEEP_BISECTION_STEPS = 8; /**< Refinements of the time of impact once an overlapping sub step is found. */
+
+	std::vector<std::uint32_t> _queryStamps; /**< Last query that visited each collider, so that colliders in several leaves are reported once. */
+	std::uint32_t _queryStamp = 0; /**< Identifier of the current query. */
+
+	static constexpr std::size_t MIN_RAYS_PER_THREAD = 256; /**< Under this count a thread of the batched ray casts costs more than it saves. */
+	ThreadPool _threadPool; /**< Workers of the batched ray casts, kept between the calls. */
+
+	static constexpr std::uint32_t SNAPSHOT_MAGIC = 0x534E5742; /**< "BWNS" read as little endian, identifies a snapshot. */
+	static constexpr std::uint32_t SNAPSHOT_VERSION = 2; /**< Version of the snapshot layout, increased on every change of it. */
+
+	std::vector<PotentialPair> _potentialPairs; /**< Pairs of the step, sorted before being tested in deterministic mode. */
+	bool _isDeterministic = false; /**< Flag indicating if the pairs are tested in a fixed order. */
+
+	QuadTreeTuner _quadTreeTuner; /**< Search of the QuadTree limits lowering the pair tests. */
+	bool _isQuadTreeTuned = false; /**< Flag indicating if the QuadTree limits are tuned at every step. */
+
+	WorldProfile _profile; /**< Stage timings of the last update. */
+	bool _isProfilingEnabled = false; /**< Flag indicating if the stage timings are measured. */
 
 public:
-	std::vector<size_t> BodyGenIndices; /**< Indices of generated bodies. */
-	std::vector<size_t> ColliderGenIndices; /**< Indices of generated colliders. */
+	std::vector<std::uint32_t> BodyGenIndices; /**< Generation of each body slot, increased when its body is destroyed. */
+	std::vector<std::uint32_t> ColliderGenIndices; /**< Generation of each collider slot, increased when its collider is destroyed. */
 	QuadTree QuadTree{ _heapAlloc };/**< QuadTree for collision checks */
+	::QuadTree StaticQuadTree{ _heapAlloc }; /**< QuadTree of the colliders of static bodies, only rebuilt when they change. */
 	/**
 	 * @brief Default constructor for the _world class.
 	 */
@@ -34,6 +184,7 @@ public:
 
 	/**
 	 * @brief Set up the initial state of the world.
+	 * @param initSize The number of body and collider slots, at most the number a reference can index.
 	 */
 	void SetUp(int initSize = 100) noexcept;
 
@@ -48,18 +199,64 @@ public:
 	 */
 	void Update(const float deltaTime) noexcept;
 
+	/**
+	 * @brief Simulate a frame using fixed time steps.
+	 * @param frameTime The time elapsed since the last frame.
+	 * @return The number of steps simulated, 0 if the frame time has been accumulated for the next frame.
+	 * @note The forces applied before the call act on every step of the frame and are cleared afterward.
+	 * If the frame needs more than the maximum number of steps, the time left behind is dropped.
+	 */
+	int FixedUpdate(const float frameTime) noexcept;
+
+	/**
+	 * @brief Set the time step and the sub step cap of FixedUpdate.
+	 * @param fixedDeltaTime The duration of a step.
+	 * @param maxSubSteps The maximum number of steps simulated in one frame.
+	 */
+	void SetFixedTimeStep(const float fixedDeltaTime, const int maxSubSteps = 5) noexcept;
+
+	/**
+	 * @brief Get how far the accumulated time is between the last step and the next one.
+	 * @return A value in [0, 1[ to interpolate from the previous to the current positions.
+	 */
+	[[nodiscard]] float GetInterpolationAlpha() const noexcept { return _accumulator / _fixedDeltaTime; }
+
+	/**
+	 * @brief Get the position of a body interpolated between the last two steps, for rendering.
+	 * @param bodyRef The reference to the body.
+	 * @return The interpolated position of the body.
+	 */
+	[[nodiscard]] XMVECTOR GetInterpolatedPosition(const BodyRef bodyRef);
+
+	/**
+	 * @brief Set the previous position of every body to its current one.
+	 * @note Call it after spawning or teleporting bodies, so that they are not interpolated from their former place.
+	 */
+	void ResetInterpolation() noexcept;
+
 	/**
 	 * @brief Create a new body in the world.
 	 * @return A reference to the created body.
+	 * @throw std::runtime_error if every slot a reference can index is used.
 	 */
-	[[nodiscard]] BodyRef CreateBody() noexcept;
+	[[nodiscard]] BodyRef CreateBody();
 
 	/**
-	 * @brief Destroy a body in the world.
-	 * @param bodyRef The reference to the body to be destroyed.
+	 * @brief Destroy a body in the world, with the colliders attached to it.
+	 * @param bodyRef The reference to the body to be destroyed, invalid after the call.
 	 */
 	void DestroyBody(const BodyRef bodyRef);
 
+	/**
+	 * @brief Check if a reference still points to its body, in O(1).
+	 * @param bodyRef The reference.
+	 * @return false if the body was destroyed or the reference is out of the world.
+	 */
+	[[nodiscard]] bool IsValid(const BodyRef bodyRef) const noexcept
+	{
+		return bodyRef.Index() < BodyGenIndices.size() && BodyGenIndices[bodyRef.Index()] == bodyRef.GenIndex();
+	}
+
 	/**
 	 * @brief Get a reference to a body in the world.
 	 * @param bodyRef The reference to the desired body.
@@ -67,12 +264,20 @@ public:
 	 */
 	[[nodiscard]] Body& GetBody(const BodyRef bodyRef);
 
+	/**
+	 * @brief Get every body slot of the world, disabled ones included, for subsystems working on all of them at once.
+	 * @return A reference to the bodies, indexed like the BodyRef indices.
+	 */
+	[[nodiscard]] std::vector<Body>& GetBodies() noexcept { return _bodies; }
+	[[nodiscard]] const std::vector<Body>& GetBodies() const noexcept { return _bodies; }
+
 	/**
 	 * @brief Create a new collider attached to a specific body in the world.
 	 * @param bodyRef The reference to the body that the collider will be attached to.
 	 * @return A reference to the created collider.
+	 * @throw std::runtime_error if the body is not found or every slot a reference can index is used.
 	 */
-	[[nodiscard]] ColliderRef CreateCollider(const BodyRef bodyRef) noexcept;
+	[[nodiscard]] ColliderRef CreateCollider(const BodyRef bodyRef);
 
 	/**
 	 * @brief Get a reference to a collider in the world.
@@ -82,11 +287,65 @@ public:
 	[[nodiscard]] Collider& GetCollider(const ColliderRef colRef);
 
 	/**
-	 * @brief Destroy a collider in the world.
-	 * @param colRef The reference to the collider to be destroyed.
+	 * @brief Destroy a collider in the world, ending its trigger overlaps with an exit event.
+	 * @param colRef The reference to the collider to be destroyed, invalid after the call.
 	 */
 	void DestroyCollider(const ColliderRef colRef);
 
+	/**
+	 * @brief Check if a reference still points to its collider, in O(1).
+	 * @param colRef The reference.
+	 * @return false if the collider was destroyed or the reference is out of the world.
+	 */
+	[[nodiscard]] bool IsValid(const ColliderRef colRef) const noexcept
+	{
+		return colRef.Index() < ColliderGenIndices.size() && ColliderGenIndices[colRef.Index()] == colRef.GenIndex();
+	}
+
+	/**
+	 * @brief Create bodies in one contiguous range, after the last enabled body.
+	 * @param count The number of bodies to create.
+	 * @param bodyRefs The buffer the references of the bodies are appended to.
+	 * @param init The function initializing each body, called with the body and its number in the range.
+	 * @note The slots are reserved once, so spawning many bodies costs no search per body.
+	 * @throw std::runtime_error if the bodies would not fit in the slots a reference can index.
+	 */
+	template<typename BodyInit>
+	void CreateBodies(std::size_t count, std::vector<BodyRef>& bodyRefs, BodyInit&& init)
+	{
+		const std::size_t first = ReserveBodies(count, bodyRefs);
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			init(_bodies[first + i], i);
+		}
+	}
+
+	/**
+	 * @brief Register a shape prototype, shared by the colliders created from it.
+	 * @param shape The shape.
+	 * @return The identifier of the prototype.
+	 */
+	[[nodiscard]] ShapeId CreateShape(ColliderShape shape) noexcept;
+
+	/**
+	 * @brief Get a shape prototype.
+	 * @param shapeId The identifier of the prototype.
+	 * @return The shape.
+	 * @throws std::runtime_error if no prototype has this identifier.
+	 */
+	[[nodiscard]] const ColliderShape& GetShape(ShapeId shapeId) const;
+
+	/**
+	 * @brief Create one collider of the same shape for each body, in one contiguous range.
+	 * @param bodyRefs The bodies the colliders are attached to.
+	 * @param shapeId The shape prototype of the colliders, polygons share their vertices with it.
+	 * @param colRefs The buffer the references of the colliders are appended to.
+	 * @param prototype The collider the other properties, like the restitution or the layers, are copied from.
+	 * @throws std::runtime_error if a body or the shape does not exist.
+	 */
+	void CreateColliders(const std::vector<BodyRef>& bodyRefs, ShapeId shapeId, std::vector<ColliderRef>& colRefs,
+		const Collider& prototype = Collider());
+
 	/**
 	 * @brief Set a contact listener to receive collision events.
 	 * @param listener A pointer to the contact listener object.
@@ -95,22 +354,472 @@ public:
 		_contactListener = listener;
 	}
 
+	/**
+	 * @brief Set the listener notified after every step, once per Update and once per step of FixedUpdate.
+	 * @param listener The listener, nullptr to remove it.
+	 */
+	void SetUpdateListener(UpdateListener* listener) noexcept { _updateListener = listener; }
+
+	/**
+	 * @brief Set the acceleration of every dynamic body, applied by the integration without waking sleeping bodies up.
+	 * @param gravity The acceleration.
+	 */
+	void SetGravity(XMVECTOR gravity) noexcept { _gravity = gravity; }
+
+	/**
+	 * @brief Get the acceleration of every dynamic body.
+	 */
+	[[nodiscard]] XMVECTOR GetGravity() const noexcept { return _gravity; }
+
+	/**
+	 * @brief Set the rate at which the velocities of the dynamic bodies decrease.
+	 * @param linearDamping The damping per second, 0 to keep the velocities.
+	 */
+	void SetLinearDamping(float linearDamping) noexcept { _linearDamping = Max(linearDamping, 0.f); }
+
+	/**
+	 * @brief Add a force field, evaluated with the gravity on every awake dynamic body.
+	 * @param field The field.
+	 * @return The index of the field.
+	 */
+	std::size_t AddForceField(const ForceField& field) noexcept
+	{
+		_forceFields.push_back(field);
+		return _forceFields.size() - 1;
+	}
+
+	/**
+	 * @brief Get the force fields, to move or change them.
+	 */
+	[[nodiscard]] std::vector<ForceField>& GetForceFields() noexcept { return _forceFields; }
+
+	/**
+	 * @brief Remove every force field.
+	 */
+	void ClearForceFields() noexcept { _forceFields.clear(); }
+
+	/**
+	 * @brief Keep the dynamic bodies inside an area, their velocity reflected on its sides.
+	 * @param bounds The area.
+	 * @note A body is contained by the bounds of its colliders at the last step, which always contain its position.
+	 * It is pushed back inside by the integration, without changing the speed it bounces back with.
+	 */
+	void SetBounds(const RectangleF& bounds) noexcept
+	{
+		_bounds = bounds;
+		_hasBounds = true;
+	}
+
+	/**
+	 * @brief Let the bodies leave the bounds.
+	 */
+	void ClearBounds() noexcept { _hasBounds = false; }
+
+	/**
+	 * @brief Enable or disable body sleeping.
+	 * @param isEnabled true to let resting islands fall asleep, false to wake every body up and keep them awake.
+	 * @note Sleeping bodies are skipped by the integration and keep their bounds in the broadphase.
+	 * They are woken up by a contact with an awake body or by a force applied with wake up.
+	 */
+	void SetSleepingEnabled(bool isEnabled) noexcept;
+
+	/**
+	 * @brief Switch both QuadTrees between tight and loose.
+	 * @param isLoose true to store each collider once, in the deepest node whose loose bounds contain it,
+	 * false to copy it in every leaf it overlaps.
+	 * @note A loose tree never duplicates the large colliders, at the cost of queries visiting more nodes.
+	 */
+	void SetLooseQuadTree(bool isLoose) noexcept
+	{
+		QuadTree.SetLoose(isLoose);
+		StaticQuadTree.SetLoose(isLoose);
+		_isStaticTreeDirty = true;
+	}
+
+	/**
+	 * @brief Set the subdivision limits of both QuadTrees.
+	 * @param maxColliders The number of colliders over which a node is subdivided.
+	 * @param maxDepth The depth at which the nodes stop being subdivided, at most 8.
+	 * @note The tuning, if enabled, starts again from these limits.
+	 */
+	void SetQuadTreeLimits(int maxColliders, int maxDepth) noexcept;
+
+	/**
+	 * @brief Enable or disable the tuning of the QuadTree limits.
+	 * @param isEnabled true to search, step after step, the limits of the dynamic QuadTree testing the fewest pairs,
+	 * false to keep the limits found so far.
+	 * @note The tree shape changes which pairs are tested, so a tuned world only matches another tuned world.
+	 */
+	void SetQuadTreeTuning(bool isEnabled) noexcept;
+
+	/**
+	 * @brief Get the search of the QuadTree limits, with the limits kept so far and their cost.
+	 */
+	[[nodiscard]] const QuadTreeTuner& GetQuadTreeTuner() const noexcept { return _quadTreeTuner; }
+
+	/**
+	 * @brief Rebuild the static QuadTree at the next step.
+	 * @note Moving, adding or removing static colliders is detected, but a change of their shape, trigger flag
+	 * or layers must be reported with this call.
+	 */
+	void MarkStaticTreeDirty() noexcept { _isStaticTreeDirty = true; }
+
+	/**
+	 * @brief Set when a body is considered resting and how long its island must rest before sleeping.
+	 * @param sleepVelocity The speed under which a body is resting.
+	 * @param timeToSleep The time every body of an island must rest before it falls asleep.
+	 */
+	void SetSleepThresholds(float sleepVelocity, float timeToSleep) noexcept
+	{
+		_sleepVelocity = sleepVelocity;
+		_timeToSleep = timeToSleep;
+	}
+
+	/**
+	 * @brief Enable or disable the measurement of the stage timings in Update.
+	 * @param isEnabled true to measure the stages, false otherwise.
+	 */
+	void SetProfilingEnabled(bool isEnabled) noexcept { _isProfilingEnabled = isEnabled; }
+
+	/**
+	 * @brief Get the stage timings of the last update.
+	 * @return The profile of the last update, with zeroed timings if profiling is disabled.
+	 */
+	[[nodiscard]] const WorldProfile& GetProfile() const noexcept { return _profile; }
+
+	/**
+	 * @brief Enable or disable the deterministic mode.
+	 * @param isEnabled true to test the pairs of each step once, ordered by collider indices, false to test them
+	 * in the QuadTree traversal order.
+	 * @note Two worlds built with the same calls then simulate bit identical states, on any platform as long as
+	 * the physics is compiled with PHYSICS_STRICT_FP.
+	 */
+	void SetDeterministic(bool isEnabled) noexcept { _isDeterministic = isEnabled; }
+
+	/**
+	 * @brief Check if the deterministic mode is enabled.
+	 */
+	[[nodiscard]] bool IsDeterministic() const noexcept { return _isDeterministic; }
+
+	/**
+	 * @brief Hash the simulation state, to compare worlds without comparing their bodies.
+	 * @return The FNV-1a hash of the state of every body.
+	 */
+	[[nodiscard]] std::uint64_t StateHash() const noexcept;
+
+	/**
+	 * @brief Write the simulation state in a binary buffer.
+	 * @param buffer The buffer, resized to the snapshot, its capacity is reused from one snapshot to the next.
+	 * @note The bodies, colliders, generation indices, trigger pairs and fixed step accumulator are saved.
+	 * The settings of the world and the QuadTrees, rebuilt every step, are not.
+	 * The layout is the memory one, a snapshot is only restored on the platform that wrote it.
+	 */
+	void Snapshot(std::vector<std::uint8_t>& buffer) const noexcept;
+
+	/**
+	 * @brief Restore the simulation state written by Snapshot.
+	 * @param data The snapshot.
+	 * @param size The size of the snapshot in bytes.
+	 * @throws std::runtime_error if the snapshot is truncated or of another version.
+	 */
+	void Restore(const std::uint8_t* data, std::size_t size);
+
+	/**
+	 * @brief Restore the simulation state written by Snapshot.
+	 * @param buffer The snapshot.
+	 * @throws std::runtime_error if the snapshot is truncated or of another version.
+	 */
+	void Restore(const std::vector<std::uint8_t>& buffer) { Restore(buffer.data(), buffer.size()); }
+
+	/**
+	 * @brief Find the closest collider hit by a ray.
+	 * @param origin The start of the ray.
+	 * @param direction The direction of the ray, it does not need to be normalized.
+	 * @param maxDistance The length of the ray.
+	 * @param hit The closest hit, written if there is one.
+	 * @param layerMask The categories of the colliders that can be hit.
+	 * @return true if a collider was hit, false otherwise.
+	 * @note The queries walk the QuadTree of the last update, with the current positions of the bodies.
+	 */
+	[[nodiscard]] bool RayCast(XMVECTOR origin, XMVECTOR direction, float maxDistance, RayCastHit& hit,
+		std::uint32_t layerMask = Collider::ALL_LAYERS) noexcept;
+
+	/**
+	 * @brief Find the closest collider hit by each ray of a batch, on the workers of the world.
+	 * @param rays The rays to cast.
+	 * @param rayCount The number of rays.
+	 * @param hits The closest hit of each ray, the buffer must hold rayCount hits.
+	 * @param layerMask The categories of the colliders that can be hit.
+	 * @return The number of rays that hit a collider.
+	 */
+	std::size_t RayCasts(const Ray* rays, std::size_t rayCount, RayCastHit* hits,
+		std::uint32_t layerMask = Collider::ALL_LAYERS) noexcept;
+
+	/**
+	 * @brief Find the colliders overlapping an area.
+	 * @param aabb The area.
+	 * @param results The buffer receiving the colliders.
+	 * @param capacity The size of the buffer, the query stops once it is full.
+	 * @param layerMask The categories of the colliders that can be found.
+	 * @return The number of colliders written.
+	 */
+	std::size_t QueryAabb(const RectangleF& aabb, ColliderRef* results, std::size_t capacity,
+		std::uint32_t layerMask = Collider::ALL_LAYERS) noexcept;
+
+	/**
+	 * @brief Find the colliders containing a point.
+	 * @param point The point.
+	 * @param results The buffer receiving the colliders.
+	 * @param capacity The size of the buffer, the query stops once it is full.
+	 * @param layerMask The categories of the colliders that can be found.
+	 * @return The number of colliders written.
+	 */
+	std::size_t QueryPoint(XMVECTOR point, ColliderRef* results, std::size_t capacity,
+		std::uint32_t layerMask = Collider::ALL_LAYERS) noexcept;
+
+	/**
+	 * @brief Find the first collider met by a shape moving in a straight line.
+	 * @param shape The moving shape.
+	 * @param position The start position of the shape.
+	 * @param direction The direction of the move, it does not need to be normalized.
+	 * @param maxDistance The length of the move.
+	 * @param hit The first collider met, written if there is one.
+	 * @param layerMask The categories of the colliders that can be met.
+	 * @return true if the shape met a collider, false otherwise.
+	 * @note The time of impact is found like the continuous collisions, by sub steps and bisection.
+	 */
+	[[nodiscard]] bool ShapeCast(const ColliderShape& shape, XMVECTOR position, XMVECTOR direction, float maxDistance,
+		ShapeCastHit& hit, std::uint32_t layerMask = Collider::ALL_LAYERS) noexcept;
+
 private:
+	/**
+	 * @brief Enable count default bodies after the last enabled one, growing the bodies once if needed.
+	 * @param count The number of bodies.
+	 * @param bodyRefs The buffer the references of the bodies are appended to.
+	 * @return The index of the first body.
+	 * @throw std::runtime_error if the bodies would not fit in the slots a reference can index.
+	 */
+	std::size_t ReserveBodies(std::size_t count, std::vector<BodyRef>& bodyRefs);
+
+	/**
+	 * @brief Simulate one step: integration, QuadTree and collisions.
+	 * @param deltaTime The time step for the simulation.
+	 * @param resetForces Flag indicating if the forces are cleared after the integration.
+	 */
+	void Step(const float deltaTime, const bool resetForces) noexcept;
+
 	/**
 	 * @brief Updates all the bodies.
 	 * @param deltaTime The time step for the simulation.
+	 * @param resetForces Flag indicating if the forces are cleared after the integration.
+	 */
+	void UpdateBodies(const float deltaTime, const bool resetForces) noexcept;
+
+	/**
+	 * @brief Clear the forces of all the bodies.
+	 */
+	void ResetForces() noexcept;
+
+	/**
+	 * @brief Sum the accelerations of the force fields at a position.
+	 * @param position The position of the body.
+	 * @return The acceleration.
+	 */
+	[[nodiscard]] XMVECTOR ForceFieldAcceleration(XMVECTOR position) const noexcept;
+
+	/**
+	 * @brief Get a body without checking its reference, for the references of the colliders and entries of the step.
 	 */
-	void UpdateBodies(const float deltaTime) noexcept;
+	[[nodiscard]] Body& GetBodyUnchecked(const BodyRef bodyRef) noexcept { return _bodies[bodyRef.Index()]; }
+
+	/**
+	 * @brief Get a collider without checking its reference, for the references of the entries of the step.
+	 */
+	[[nodiscard]] Collider& GetColliderUnchecked(const ColliderRef colRef) noexcept { return _colliders[colRef.Index()]; }
 
 	/**
 	 * @brief Initialisation of the QuadTree.
 	 */
 	void SetUpQuadTree() noexcept;
+
+	/**
+	 * @brief Rebuild the QuadTree of the colliders of static bodies.
+	 */
+	void SetUpStaticQuadTree() noexcept;
+
+	/**
+	 * @brief Rebuild both QuadTrees from restored colliders, so that the queries before the next update see the restored world.
+	 */
+	void SetUpRestoredQuadTrees() noexcept;
+
+	/**
+	 * @brief Build the islands of touching bodies and put to sleep the ones that rested long enough.
+	 * @param deltaTime The time step for the simulation.
+	 */
+	void UpdateSleep(const float deltaTime) noexcept;
+
+	/**
+	 * @brief Find the island root of a body, compressing the path on the way.
+	 * @param bodyIndex The index of the body.
+	 * @return The index of the root body of the island.
+	 */
+	[[nodiscard]] std::size_t FindIsland(std::size_t bodyIndex) noexcept;
+
+	/**
+	 * @brief Wake up the sleeping bodies of a physical contact.
+	 */
+	static void WakeOnContact(Body& body1, Body& body2) noexcept
+	{
+		if (!body1.IsAwake())
+		{
+			body1.WakeUp();
+		}
+		if (!body2.IsAwake())
+		{
+			body2.WakeUp();
+		}
+	}
+
+	/**
+	 * @brief Search the first time of the last step where two colliders touched, at least one of them being continuous.
+	 * @param entry1 The QuadTree entry of the first collider.
+	 * @param entry2 The QuadTree entry of the second collider.
+	 * @param moveToImpact Flag indicating if the continuous bodies are left at the time of impact, otherwise they are put back.
+	 * @return true if the colliders touched during the step.
+	 * @note The move is cut in sub steps shorter than half the smaller collider, the first overlapping one is refined by bisection.
+	 */
+	[[nodiscard]] bool SweepToImpact(const ColliderRefAabb& entry1, const ColliderRefAabb& entry2, bool moveToImpact) noexcept;
+
+	/**
+	 * @brief Get the collider of a QuadTree entry if a query can report it.
+	 * @param entry The QuadTree entry.
+	 * @param layerMask The categories accepted by the query.
+	 * @return The collider, or nullptr if it was destroyed since the last update or is filtered out.
+	 */
+	[[nodiscard]] const Collider* GetQueryCollider(const ColliderRefAabb& entry, std::uint32_t layerMask) noexcept;
+
+	/**
+	 * @brief Start a query that reports each collider once.
+	 */
+	void BeginQuery() noexcept;
+
+	/**
+	 * @brief Mark a collider as visited by the current query.
+	 * @param colRef The reference of a tree entry.
+	 * @return true the first time the collider is visited by the query, false after or if the reference is no longer valid.
+	 */
+	[[nodiscard]] bool MarkQueried(ColliderRef colRef) noexcept;
+
+	/**
+	 * @brief Call a function on every QuadTree node holding entries whose loose bounds overlap an area.
+	 * @param tree The tree to walk.
+	 * @param nodeIndex The index of the node to start from.
+	 * @param aabb The area.
+	 * @param function The function called with the entries of each node that may overlap the area,
+	 * only the leaves of a tight tree hold entries.
+	 */
+	template <typename Function>
+	void ForEachNode(const ::QuadTree& tree, const std::size_t nodeIndex, const RectangleF& aabb, Function&& function) const
+	{
+		const auto& node = tree.Nodes[nodeIndex];
+		if (!Intersect(node.LooseBounds, aabb))
+		{
+			return;
+		}
+		if (node.ItemCount > 0)
+		{
+			function(tree.GetItems(node, aabb));
+		}
+		if (node.IsLeaf)
+		{
+			return;
+		}
+		const std::size_t firstChild = ::QuadTree::FirstChild(nodeIndex);
+		for (std::size_t child = firstChild; child < firstChild + 4; ++child)
+		{
+			ForEachNode(tree, child, aabb, function);
+		}
+	}
+
+	/**
+	 * @brief Call a function with the entries of each node of the dynamic and static QuadTrees that may overlap bounds.
+	 * @param aabb The bounds to visit.
+	 * @param function The function called with the entries of each node.
+	 */
+	template <typename Function>
+	void ForEachNode(const RectangleF& aabb, Function&& function) const
+	{
+		ForEachNode(QuadTree, 0, aabb, function);
+		if (!_staticQuadTreeEntries.empty())
+		{
+			ForEachNode(StaticQuadTree, 0, aabb, function);
+		}
+	}
+
+	/**
+	 * @brief Cast a ray through a QuadTree node, keeping the closest hit.
+	 * @param tree The tree of the node.
+	 * @param nodeIndex The index of the node to cast through.
+	 * @param ray The ray, with a normalized direction.
+	 * @param layerMask The categories of the colliders that can be hit.
+	 * @param hit The closest hit so far, its distance shortens the ray.
+	 */
+	void RayCastNode(const ::QuadTree& tree, std::size_t nodeIndex, const Ray& ray, std::uint32_t layerMask, RayCastHit& hit) noexcept;
+
+	/**
+	 * @brief Cast a ray with a normalized direction from the QuadTree root.
+	 */
+	[[nodiscard]] bool RayCast(const Ray& ray, RayCastHit& hit, std::uint32_t layerMask) noexcept;
+
 	/**
 	 * @brief recursive update of the QuadTree.
-	 * @param node the root node
+	 * @param nodeIndex the index of the node, 0 for the root
+	 */
+	void UpdateQuadTreeCollisions(std::size_t nodeIndex)noexcept;
+
+	/**
+	 * @brief Find the pairs of the loose QuadTree, each moving collider querying the nodes around it.
+	 * @note A pair is tested from its collider of lower index, the other one skips it.
+	 */
+	void UpdateLooseQuadTreeCollisions() noexcept;
+
+	/**
+	 * @brief Find and test the pairs of the step, in both QuadTrees.
+	 */
+	void UpdateCollisions() noexcept;
+
+	/**
+	 * @brief Keep a pair for the deterministic test, ordered by collider indices.
+	 * @param entry1 The entry of the first collider.
+	 * @param entry2 The entry of the second collider.
+	 */
+	void AddPotentialPair(const ColliderRefAabb& entry1, const ColliderRefAabb& entry2) noexcept;
+
+	/**
+	 * @brief Test the kept pairs in order, once each.
+	 */
+	void TestPotentialPairs() noexcept;
+
+	/**
+	 * @brief Test the moving colliders against the static QuadTree.
+	 */
+	void UpdateStaticCollisions() noexcept;
+
+	/**
+	 * @brief Check if a pair can be skipped from its entries alone.
+	 * @param entry1 The entry of the first collider.
+	 * @param entry2 The entry of the second collider.
+	 * @return true if the layers, the resting state or the trigger flags rule out the pair.
+	 */
+	[[nodiscard]] bool IsPairFiltered(const ColliderRefAabb& entry1, const ColliderRefAabb& entry2) const noexcept;
+
+	/**
+	 * @brief Test a pair of colliders, resolving the contact and reporting the events.
+	 * @param entry1 The entry of the first collider.
+	 * @param col1 The first collider.
+	 * @param entry2 The entry of the second collider.
 	 */
-	void UpdateQuadTreeCollisions(const QuadNode& node)noexcept;
+	void TestPair(const ColliderRefAabb& entry1, Collider& col1, const ColliderRefAabb& entry2) noexcept;
 
 	/**
 	 * @brief Check if two colliders overlap.
@@ -1,6 +1,14 @@
 #include "Body.h"
 
-void Body::ApplyForce(const XMVECTOR &force) noexcept
+void Body::ApplyForce(const XMVECTOR &force, const bool wakeUp) noexcept
 {
+    if (!_isAwake)
+    {
+        if (!wakeUp)
+        {
+            return;
+        }
+        WakeUp();
+    }
     _force = XMVectorAdd(_force, force);
 }
\ No newline at end of file
@@ -1,25 +1,29 @@
 #include "Collider.h"
 
-RectangleF Collider::GetBounds() const noexcept
+#ifdef TRACY_ENABLE
+#include <Tracy.hpp>
+#endif
+
+RectangleF GetBounds(const ColliderShape& shape, const XMVECTOR position) noexcept
 {
-	switch (Shape.index())
+	switch (shape.index())
 	{
 	case static_cast<int>(ShapeType::Circle):
 	{
-		auto circle = std::get<CircleF>(Shape);
-		return RectangleF::FromCenter(circle.Center(), { circle.Radius(), circle.Radius() }) + BodyPosition;
+		auto circle = std::get<CircleF>(shape);
+		return RectangleF::FromCenter(circle.Center(), { circle.Radius(), circle.Radius() }) + position;
 	}
 	case static_cast<int>(ShapeType::Rectangle):
 	{
-		return std::get<RectangleF>(Shape) + BodyPosition;
+		return std::get<RectangleF>(shape) + position;
 	}
 	case static_cast<int>(ShapeType::Polygon):
 	{
 		float minX = std::numeric_limits<float>::max();
 		float minY = std::numeric_limits<float>::max();
-		float maxX = std::numeric_limits<float>::min();
-		float maxY = std::numeric_limits<float>::min();
-		PolygonF polygon = std::get<PolygonF>(Shape);
+		float maxX = std::numeric_limits<float>::lowest();
+		float maxY = std::numeric_limits<float>::lowest();
+		const auto& polygon = std::get<PolygonF>(shape);
 
 		for (auto& vertex : polygon.Vertices())
 		{
@@ -33,24 +37,150 @@ RectangleF Collider::GetBounds() const noexcept
 			maxY = std::max(maxY, y);
 		}
 
-		return RectangleF{ XMVECTOR{minX, minY}, XMVECTOR{maxX, maxY} } + BodyPosition;
+		return RectangleF{ XMVECTOR{minX, minY}, XMVECTOR{maxX, maxY} } + position;
+	}
+	case static_cast<int>(ShapeType::OrientedRectangle):
+	{
+		const auto& rectangle = std::get<OrientedRectangleF>(shape);
+		return RectangleF::FromCenter(XMVectorAdd(rectangle.Center(), position), rectangle.Extents());
 	}
 	}
 	return { XMVectorZero(), XMVectorZero() };
 }
 
+RectangleF Collider::GetBounds() const noexcept
+{
+	return ::GetBounds(Shape, BodyPosition);
+}
+
+bool Overlap(const ColliderShape& shapeA, const XMVECTOR positionA, const ColliderShape& shapeB, const XMVECTOR positionB) noexcept
+{
+	const auto ShapeA = static_cast<ShapeType>(shapeA.index());
+	const auto ShapeB = static_cast<ShapeType>(shapeB.index());
+
+#ifdef TRACY_ENABLE
+	ZoneScoped;
+	/*static constexpr const char* names[] = { "Circle", "Rectangle", "Polygon", "OrientedRectangle", "None" };
+	const auto log = fmt::format("Shape A: {}, Shape B: {}", names[static_cast<int>(ShapeA)], names[static_cast<int>(ShapeB)]);
+	ZoneText(log.data(), log.size());*/
+#endif
+
+	switch (ShapeA)
+	{
+	case ShapeType::Circle:
+	{
+		CircleF circle = std::get<CircleF>(shapeA) + positionA;
+		switch (ShapeB)
+		{
+		case ShapeType::Circle:
+			return Intersect(circle, std::get<CircleF>(shapeB) + positionB);
+		case ShapeType::Rectangle:
+			return Intersect(circle, std::get<RectangleF>(shapeB) + positionB);
+			case ShapeType::Polygon:
+				return Intersect(circle, std::get<PolygonF>(shapeB) + positionB);
+		case ShapeType::OrientedRectangle:
+			return Intersect(circle, std::get<OrientedRectangleF>(shapeB) + positionB);
+		}
+		break;
+	}
+	case ShapeType::Rectangle:
+	{
+		RectangleF rect = std::get<RectangleF>(shapeA) + positionA;
+		switch (ShapeB)
+		{
+		case ShapeType::Circle:
+			return Intersect(rect, std::get<CircleF>(shapeB) + positionB);
+		case ShapeType::Rectangle:
+			return Intersect(rect, std::get<RectangleF>(shapeB) + positionB);
+			case ShapeType::Polygon:
+				return Intersect(rect, std::get<PolygonF>(shapeB) + positionB);
+		case ShapeType::OrientedRectangle:
+			return Intersect(rect, std::get<OrientedRectangleF>(shapeB) + positionB);
+		}
+		break;
+	}
+	case ShapeType::Polygon:
+	{
+		PolygonF pol = std::get<PolygonF>(shapeA) + positionA;
+		switch (ShapeB)
+		{
+		case ShapeType::Circle:
+			return Intersect(pol, std::get<CircleF>(shapeB) + positionB);
+		case ShapeType::Rectangle:
+			return Intersect(pol, std::get<RectangleF>(shapeB) + positionB);
+		case ShapeType::Polygon:
+			return Intersect(pol, std::get<PolygonF>(shapeB) + positionB);
+		case ShapeType::OrientedRectangle:
+			return Intersect(pol, std::get<OrientedRectangleF>(shapeB) + positionB);
+		}
+		break;
+	}
+	case ShapeType::OrientedRectangle:
+	{
+		// Nothing allocated unless the other shape is a polygon
+		const OrientedRectangleF rect = std::get<OrientedRectangleF>(shapeA) + positionA;
+		switch (ShapeB)
+		{
+		case ShapeType::Circle:
+			return Intersect(rect, std::get<CircleF>(shapeB) + positionB);
+		case ShapeType::Rectangle:
+			return Intersect(rect, std::get<RectangleF>(shapeB) + positionB);
+		case ShapeType::Polygon:
+			return Intersect(rect, std::get<PolygonF>(shapeB) + positionB);
+		case ShapeType::OrientedRectangle:
+			return Intersect(rect, std::get<OrientedRectangleF>(shapeB) + positionB);
+		}
+		break;
+	}
+	}
+	return false;
+}
+
+bool Contains(const ColliderShape& shape, const XMVECTOR position, const XMVECTOR point) noexcept
+{
+	// The point is moved in the shape space, so that polygons are not copied
+	const auto localPoint = XMVectorSubtract(point, position);
+
+	switch (shape.index())
+	{
+	case static_cast<int>(ShapeType::Circle):
+		return std::get<CircleF>(shape).Contains(localPoint);
+	case static_cast<int>(ShapeType::Rectangle):
+		return std::get<RectangleF>(shape).Contains(localPoint);
+	case static_cast<int>(ShapeType::Polygon):
+		return std::get<PolygonF>(shape).Contains(localPoint);
+	case static_cast<int>(ShapeType::OrientedRectangle):
+		return std::get<OrientedRectangleF>(shape).Contains(localPoint);
+	}
+	return false;
+}
+
+bool RayCast(const ColliderShape& shape, const XMVECTOR position, const XMVECTOR origin, const XMVECTOR direction,
+	const float maxDistance, float& distance, XMVECTOR& normal) noexcept
+{
+	const auto localOrigin = XMVectorSubtract(origin, position);
+
+	switch (shape.index())
+	{
+	case static_cast<int>(ShapeType::Circle):
+		return RayCast(std::get<CircleF>(shape), localOrigin, direction, maxDistance, distance, normal);
+	case static_cast<int>(ShapeType::Rectangle):
+		return RayCast(std::get<RectangleF>(shape), localOrigin, direction, maxDistance, distance, normal);
+	case static_cast<int>(ShapeType::Polygon):
+		return RayCast(std::get<PolygonF>(shape), localOrigin, direction, maxDistance, distance, normal);
+	case static_cast<int>(ShapeType::OrientedRectangle):
+		return RayCast(std::get<OrientedRectangleF>(shape), localOrigin, direction, maxDistance, distance, normal);
+	}
+	return false;
+}
+
 bool ColliderRefPair::operator==(const ColliderRefPair& other) const
 {
-	return (ColRefA == other.ColRefA && ColRefB == other.ColRefB) ||
-		(ColRefA == other.ColRefB && ColRefB == other.ColRefA);
+	return Key() == other.Key();
 }
 
 
 std::size_t ColliderRefPairHash::operator()(const ColliderRefPair& pair) const
 {
-	const std::size_t hashA = std::hash<size_t>{}(pair.ColRefA.Index);
-	const std::size_t hashB = std::hash<size_t>{}(pair.ColRefB.Index);
-
-	// XOR for the hash
-	return hashA ^ hashB;
+	return std::hash<std::uint64_t>{}(pair.Key());
 }
@@ -71,6 +71,17 @@ void Contact::Resolve()
 
 		}
 		break;
+		case static_cast<int>(ShapeType::OrientedRectangle):
+		{
+			const CircleF circle = std::get<CircleF>(CollidingBodies[0].collider->Shape) + CollidingBodies[0].body->Position;
+			const OrientedRectangleF rectangle = std::get<OrientedRectangleF>(CollidingBodies[1].collider->Shape) + CollidingBodies[1].body->Position;
+
+			if (!::Penetration(circle, rectangle, Normal, Penetration))
+			{
+				Penetration = 0.f;
+			}
+		}
+		break;
 		}
 		break;
 	case static_cast<int>(ShapeType::Rectangle):
@@ -103,7 +114,47 @@ void Contact::Resolve()
 			}
 		}
 		break;
+		case static_cast<int>(ShapeType::OrientedRectangle):
+		{
+			const auto rectangle = OrientedRectangleF::FromRectangle(std::get<RectangleF>(CollidingBodies[0].collider->Shape) + CollidingBodies[0].body->Position);
+			const OrientedRectangleF orientedRectangle = std::get<OrientedRectangleF>(CollidingBodies[1].collider->Shape) + CollidingBodies[1].body->Position;
+
+			if (!::Penetration(rectangle, orientedRectangle, Normal, Penetration))
+			{
+				Penetration = 0.f;
+			}
+		}
+		break;
 		}
+		break;
+	case static_cast<int>(ShapeType::OrientedRectangle):
+	{
+		const OrientedRectangleF rectangle = std::get<OrientedRectangleF>(CollidingBodies[0].collider->Shape) + CollidingBodies[0].body->Position;
+		const auto& otherShape = CollidingBodies[1].collider->Shape;
+		const auto otherPosition = CollidingBodies[1].body->Position;
+		bool isOverlapping = false;
+
+		switch (otherShape.index())
+		{
+		case static_cast<int>(ShapeType::Circle):
+			// The circle routine moves the circle out, the normal is turned to move the rectangle out
+			isOverlapping = ::Penetration(std::get<CircleF>(otherShape) + otherPosition, rectangle, Normal, Penetration);
+			Normal = XMVectorNegate(Normal);
+			break;
+		case static_cast<int>(ShapeType::Rectangle):
+			isOverlapping = ::Penetration(rectangle, OrientedRectangleF::FromRectangle(std::get<RectangleF>(otherShape) + otherPosition), Normal, Penetration);
+			break;
+		case static_cast<int>(ShapeType::OrientedRectangle):
+			isOverlapping = ::Penetration(rectangle, std::get<OrientedRectangleF>(otherShape) + otherPosition, Normal, Penetration);
+			break;
+		}
+
+		if (!isOverlapping)
+		{
+			Penetration = 0.f;
+		}
+	}
+	break;
 	}
 
 	const auto mass1 = CollidingBodies[0].body->Mass, mass2 = CollidingBodies[1].body->Mass;
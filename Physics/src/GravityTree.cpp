@@ -0,0 +1,286 @@
+#include "GravityTree.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#ifdef TRACY_ENABLE
+#include <Tracy.hpp>
+#endif
+
+void GravityTree::Build(const std::vector<Body>& bodies) noexcept
+{
+#ifdef TRACY_ENABLE
+	ZoneScoped;
+#endif
+	Nodes.clear();
+	_nextBodies.assign(bodies.size(), -1);
+
+	XMVECTOR maxBounds = XMVectorSet(std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(), 0, 0);
+	XMVECTOR minBounds = XMVectorSet(std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), 0, 0);
+	bool isEmpty = true;
+
+	for (const auto& body : bodies)
+	{
+		if (!body.IsEnabled() || body.Mass <= 0.f)
+		{
+			continue;
+		}
+		minBounds = XMVectorMin(minBounds, body.Position);
+		maxBounds = XMVectorMax(maxBounds, body.Position);
+		isEmpty = false;
+	}
+
+	if (isEmpty)
+	{
+		return;
+	}
+
+	// A square root node keeps the opening criterion the same along both axes
+	const auto size = XMVectorSubtract(maxBounds, minBounds);
+	const float halfSide = std::max(XMVectorGetX(size), XMVectorGetY(size)) / 2.f + 1.f;
+	const auto center = XMVectorScale(XMVectorAdd(minBounds, maxBounds), 0.5f);
+	const auto halfSize = XMVectorSet(halfSide, halfSide, 0, 0);
+
+	Nodes.reserve(2 * bodies.size() + 1);
+	Nodes.emplace_back(RectangleF(XMVectorSubtract(center, halfSize), XMVectorAdd(center, halfSize)), 0);
+
+	for (std::size_t i = 0; i < bodies.size(); ++i)
+	{
+		const auto& body = bodies[i];
+		if (!body.IsEnabled() || body.Mass <= 0.f)
+		{
+			continue;
+		}
+		Insert(static_cast<int>(i), body.Position, bodies);
+	}
+
+	ComputeMasses(bodies);
+	SortBodies();
+}
+
+void GravityTree::SortBodies() noexcept
+{
+	_sortedBodies.clear();
+
+	std::array<int, 3 * MAX_DEPTH + 4> stack{};
+	std::size_t stackSize = 0;
+	stack[stackSize++] = 0;
+
+	while (stackSize > 0)
+	{
+		const auto& node = Nodes[stack[--stackSize]];
+		if (node.FirstChild < 0)
+		{
+			for (int i = node.FirstBody; i >= 0; i = _nextBodies[i])
+			{
+				_sortedBodies.push_back(i);
+			}
+			continue;
+		}
+
+		for (int i = node.FirstChild + 3; i >= node.FirstChild; --i)
+		{
+			stack[stackSize++] = i;
+		}
+	}
+}
+
+int GravityTree::ChildIndex(const GravityNode& node, const XMVECTOR position) const noexcept
+{
+	// Children are ordered like the QuadTree ones: top left, bottom left, top right, bottom right
+	const auto center = node.Bounds.Center();
+	const int right = XMVectorGetX(position) >= XMVectorGetX(center) ? 2 : 0;
+	const int bottom = XMVectorGetY(position) >= XMVectorGetY(center) ? 1 : 0;
+
+	return node.FirstChild + right + bottom;
+}
+
+void GravityTree::SubdivideNode(const int nodeIndex) noexcept
+{
+	const auto bounds = Nodes[nodeIndex].Bounds;
+	const int depth = Nodes[nodeIndex].Depth + 1;
+
+	const XMVECTOR minBound = bounds.MinBound();
+	const XMVECTOR center = bounds.Center();
+	const XMVECTOR maxBound = bounds.MaxBound();
+
+	Nodes[nodeIndex].FirstChild = static_cast<int>(Nodes.size());
+
+	Nodes.emplace_back(RectangleF(minBound, center), depth);
+	Nodes.emplace_back(RectangleF(XMVectorSet(XMVectorGetX(minBound), XMVectorGetY(center), 0, 0),
+		XMVectorSet(XMVectorGetX(center), XMVectorGetY(maxBound), 0, 0)), depth);
+	Nodes.emplace_back(RectangleF(XMVectorSet(XMVectorGetX(center), XMVectorGetY(minBound), 0, 0),
+		XMVectorSet(XMVectorGetX(maxBound), XMVectorGetY(center), 0, 0)), depth);
+	Nodes.emplace_back(RectangleF(center, maxBound), depth);
+}
+
+void GravityTree::Insert(const int bodyIndex, const XMVECTOR position, const std::vector<Body>& bodies) noexcept
+{
+	int nodeIndex = 0;
+
+	while (true)
+	{
+		if (Nodes[nodeIndex].FirstChild >= 0)
+		{
+			nodeIndex = ChildIndex(Nodes[nodeIndex], position);
+			continue;
+		}
+
+		if (Nodes[nodeIndex].BodyCount < MAX_BODY_NBR || Nodes[nodeIndex].Depth >= MAX_DEPTH)
+		{
+			_nextBodies[bodyIndex] = Nodes[nodeIndex].FirstBody;
+			Nodes[nodeIndex].FirstBody = bodyIndex;
+			Nodes[nodeIndex].BodyCount++;
+			return;
+		}
+
+		// Move the bodies of the full leaf down, then try again with the new children
+		int previousBody = Nodes[nodeIndex].FirstBody;
+		Nodes[nodeIndex].FirstBody = -1;
+		Nodes[nodeIndex].BodyCount = 0;
+		SubdivideNode(nodeIndex);
+
+		while (previousBody >= 0)
+		{
+			const int nextBody = _nextBodies[previousBody];
+			auto& child = Nodes[ChildIndex(Nodes[nodeIndex], bodies[previousBody].Position)];
+			_nextBodies[previousBody] = child.FirstBody;
+			child.FirstBody = previousBody;
+			child.BodyCount++;
+			previousBody = nextBody;
+		}
+	}
+}
+
+void GravityTree::ComputeMasses(const std::vector<Body>& bodies) noexcept
+{
+	// Children are stored after their parent, a reverse pass sees them first
+	for (auto node = Nodes.rbegin(); node != Nodes.rend(); ++node)
+	{
+		XMVECTOR weightedPosition = XMVectorZero();
+		float mass = 0.f;
+
+		if (node->FirstChild >= 0)
+		{
+			for (int i = node->FirstChild; i < node->FirstChild + 4; ++i)
+			{
+				weightedPosition = XMVectorAdd(weightedPosition, XMVectorScale(Nodes[i].CenterOfMass, Nodes[i].Mass));
+				mass += Nodes[i].Mass;
+			}
+		}
+		else
+		{
+			for (int i = node->FirstBody; i >= 0; i = _nextBodies[i])
+			{
+				weightedPosition = XMVectorAdd(weightedPosition, XMVectorScale(bodies[i].Position, bodies[i].Mass));
+				mass += bodies[i].Mass;
+			}
+		}
+
+		node->Mass = mass;
+		node->CenterOfMass = mass > 0.f ? XMVectorScale(weightedPosition, 1.f / mass) : node->Bounds.Center();
+	}
+}
+
+XMVECTOR GravityTree::ComputeAcceleration(const std::vector<Body>& bodies, const std::size_t bodyIndex) const noexcept
+{
+	if (Nodes.empty())
+	{
+		return XMVectorZero();
+	}
+
+	const auto position = bodies[bodyIndex].Position;
+	const float openingAngleSq = _openingAngle * _openingAngle;
+	const float softeningSq = _softening * _softening;
+
+	XMVECTOR acceleration = XMVectorZero();
+
+	const auto attract = [&](const XMVECTOR center, const float mass, const float distanceSq)
+	{
+		const float softenedDistanceSq = distanceSq + softeningSq;
+		const float scale = _gravitationalConstant * mass / (softenedDistanceSq * std::sqrt(softenedDistanceSq));
+		acceleration = XMVectorAdd(acceleration, XMVectorScale(XMVectorSubtract(center, position), scale));
+	};
+
+	// Each level pushes at most 3 more nodes than it pops
+	std::array<int, 3 * MAX_DEPTH + 4> stack{};
+	std::size_t stackSize = 0;
+	stack[stackSize++] = 0;
+
+	while (stackSize > 0)
+	{
+		const auto& node = Nodes[stack[--stackSize]];
+		if (node.Mass <= 0.f)
+		{
+			continue;
+		}
+
+		const float distanceSq = XMVectorGetX(XMVector2LengthSq(XMVectorSubtract(node.CenterOfMass, position)));
+		const float side = XMVectorGetX(node.Bounds.Size());
+
+		// A node far enough attracts as a single mass, unless it holds the body which would then attract itself
+		if (side * side < openingAngleSq * distanceSq && !node.Bounds.Contains(position))
+		{
+			attract(node.CenterOfMass, node.Mass, distanceSq);
+			continue;
+		}
+
+		if (node.FirstChild < 0)
+		{
+			for (int i = node.FirstBody; i >= 0; i = _nextBodies[i])
+			{
+				if (static_cast<std::size_t>(i) == bodyIndex)
+				{
+					continue;
+				}
+				const auto& other = bodies[i];
+				attract(other.Position, other.Mass, XMVectorGetX(XMVector2LengthSq(XMVectorSubtract(other.Position, position))));
+			}
+			continue;
+		}
+
+		for (int i = node.FirstChild; i < node.FirstChild + 4; ++i)
+		{
+			stack[stackSize++] = i;
+		}
+	}
+
+	return acceleration;
+}
+
+void GravityTree::ApplyForces(std::vector<Body>& bodies, const std::size_t begin, const std::size_t end) const noexcept
+{
+	for (std::size_t sortedIndex = begin; sortedIndex < end; ++sortedIndex)
+	{
+		const auto i = static_cast<std::size_t>(_sortedBodies[sortedIndex]);
+		auto& body = bodies[i];
+		if (!body.IsEnabled() || body.Type == BodyType::STATIC || !body.IsAwake())
+		{
+			continue;
+		}
+
+		const auto acceleration = ComputeAcceleration(bodies, i);
+		body.ApplyForce(XMVectorScale(acceleration, body.Mass), false);
+	}
+}
+
+void GravityTree::ApplyForces(std::vector<Body>& bodies) noexcept
+{
+#ifdef TRACY_ENABLE
+	ZoneScoped;
+#endif
+	Build(bodies);
+
+	const std::size_t bodyCount = _sortedBodies.size();
+	const std::size_t threadCount = std::max<std::size_t>(1, std::min(_threadCount > 0 ? _threadCount : _threadPool.GetThreadCount(),
+		bodyCount / MIN_BODIES_PER_THREAD));
+	const std::size_t chunkSize = (bodyCount + threadCount - 1) / threadCount;
+
+	// The tree is only read and every chunk writes its own bodies, so no synchronisation is needed
+	_threadPool.Run(threadCount, [this, &bodies, chunkSize, bodyCount](const std::size_t chunk)
+		{
+			const std::size_t begin = chunk * chunkSize;
+			ApplyForces(bodies, begin, std::min(begin + chunkSize, bodyCount));
+		});
+}
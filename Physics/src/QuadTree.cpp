@@ -1,98 +1,251 @@
 #include "QuadTree.h"
 
-QuadNode::QuadNode(Allocator& alloc) noexcept : ColliderRefAabbs(StandardAllocator<ColliderRefPair>{alloc})
-{
-	ColliderRefAabbs.reserve(16);
-}
+#include <algorithm>
+#include <numeric>
+
+#ifdef TRACY_ENABLE
+#include <Tracy.hpp>
+#endif
 
-QuadNode::QuadNode(const RectangleF& bounds, Allocator& alloc) noexcept : ColliderRefAabbs(StandardAllocator<ColliderRefPair>{ alloc }), Bounds(bounds)
+QuadTree::QuadTree(Allocator& alloc) noexcept : Nodes{ StandardAllocator<QuadNode>{alloc} }, Items{ StandardAllocator<QuadTreeItem>{alloc} }
 {
-	ColliderRefAabbs.reserve(16);
+	Nodes.resize(1);
 }
 
-QuadTree::QuadTree(Allocator& alloc) noexcept : _alloc(alloc), Nodes{ StandardAllocator<QuadNode>{alloc} }
+void QuadTree::SubdivideNode(const std::size_t nodeIndex) noexcept
 {
-	std::size_t result = 0;
-	for (size_t i = 0; i <= MAX_DEPTH; i++)
+	const std::size_t firstChild = FirstChild(nodeIndex);
+	if (Nodes.size() < firstChild + 4)
 	{
-		result += Pow(4, i);
+		Nodes.resize(firstChild + 4);
 	}
-	Nodes.resize(result, QuadNode(_alloc));
-}
 
-void QuadTree::SubdivideNode(QuadNode& node) noexcept
-{
+	QuadNode& node = Nodes[nodeIndex];
 	const XMVECTOR halfSize = XMVectorDivide(XMVectorSubtract(node.Bounds.MaxBound(), node.Bounds.MinBound()), XMVectorSet(2, 2, 2, 2));
 	const XMVECTOR minBound = node.Bounds.MinBound();
 
-	node.Children[0] = &Nodes[_nodeIndex];
-	node.Children[0]->Bounds = { minBound, XMVectorAdd(minBound , halfSize) };
+	Nodes[firstChild].Bounds = { minBound, XMVectorAdd(minBound , halfSize) };
 
-	node.Children[1] = &Nodes[_nodeIndex + 1];
-	node.Children[1]->Bounds = { {XMVectorGetX(minBound), XMVectorGetY(minBound) + XMVectorGetY(halfSize)},
+	Nodes[firstChild + 1].Bounds = { {XMVectorGetX(minBound), XMVectorGetY(minBound) + XMVectorGetY(halfSize)},
 		{XMVectorGetX(minBound) + XMVectorGetX(halfSize), XMVectorGetY(minBound) + 2 * XMVectorGetY(halfSize)} };
 
-	node.Children[2] = &Nodes[_nodeIndex + 2];
-	node.Children[2]->Bounds = { {XMVectorGetX(minBound) + XMVectorGetX(halfSize), XMVectorGetY(minBound)},
+	Nodes[firstChild + 2].Bounds = { {XMVectorGetX(minBound) + XMVectorGetX(halfSize), XMVectorGetY(minBound)},
 		{XMVectorGetX(minBound) + 2 * XMVectorGetX(halfSize), XMVectorGetY(minBound) + XMVectorGetY(halfSize)} };
 
-	node.Children[3] = &Nodes[_nodeIndex + 3];
-	node.Children[3]->Bounds = { {XMVectorGetX(minBound) + XMVectorGetX(halfSize),
+	Nodes[firstChild + 3].Bounds = { {XMVectorGetX(minBound) + XMVectorGetX(halfSize),
 		XMVectorGetY(minBound) + XMVectorGetY(halfSize)}, node.Bounds.MaxBound() };
 
+	for (std::size_t i = firstChild; i < firstChild + 4; ++i)
+	{
+		auto& child = Nodes[i];
+		child.Depth = node.Depth + 1;
+		child.LooseBounds = GetLooseBounds(child.Bounds);
+		child.IsLeaf = true;
+		child.FirstItem = 0;
+		child.ItemCount = 0;
+	}
+	node.IsLeaf = false;
+}
 
-	for (const auto& child : node.Children)
+RectangleF QuadTree::GetLooseBounds(const RectangleF& bounds) const noexcept
+{
+	if (!_isLoose)
 	{
-		child->Depth = node.Depth + 1;
+		return bounds;
 	}
-	_nodeIndex += 4;
+	const XMVECTOR margin = bounds.HalfSize();
+	return { XMVectorSubtract(bounds.MinBound(), margin), XMVectorAdd(bounds.MaxBound(), margin) };
 }
 
-void QuadTree::Insert(QuadNode& node, const ColliderRefAabb& colliderRefAabb) noexcept
+std::uint8_t QuadTree::GetChildMask(const std::size_t nodeIndex, const RectangleF& aabb) const noexcept
 {
-	if (node.Children[0] != nullptr)
+	const std::size_t firstChild = FirstChild(nodeIndex);
+	if (!_isLoose)
 	{
-		for (const auto& child : node.Children)
+		std::uint8_t mask = 0;
+		for (std::size_t i = 0; i < 4; ++i)
 		{
-			if (Intersect(colliderRefAabb.Aabb, child->Bounds))
+			if (Intersect(aabb, Nodes[firstChild + i].Bounds))
 			{
-				Insert(*child, colliderRefAabb);
+				mask |= static_cast<std::uint8_t>(1u << i);
 			}
 		}
+		return mask;
 	}
-	else if (node.ColliderRefAabbs.size() >= MAX_COL_NBR && node.Depth < MAX_DEPTH)
+
+	// Children are ordered like in SubdivideNode: x then y halves, the minimum one first
+	const XMVECTOR center = aabb.Center();
+	const XMVECTOR nodeCenter = Nodes[nodeIndex].Bounds.Center();
+	const int childIndex = (XMVectorGetX(center) >= XMVectorGetX(nodeCenter) ? 2 : 0)
+		+ (XMVectorGetY(center) >= XMVectorGetY(nodeCenter) ? 1 : 0);
+	const auto& child = Nodes[firstChild + childIndex];
+
+	const bool isContained = XMVector2GreaterOrEqual(aabb.MinBound(), child.LooseBounds.MinBound())
+		&& XMVector2LessOrEqual(aabb.MaxBound(), child.LooseBounds.MaxBound());
+	return isContained ? static_cast<std::uint8_t>(1u << childIndex) : 0;
+}
+
+QuantizedAabb QuadTree::Quantize(const RectangleF& aabb, const RectangleF& frame) noexcept
+{
+	// A flat frame maps everything to 0, which keeps the overlaps
+	const XMVECTOR size = frame.Size();
+	const XMVECTOR scale = XMVectorSelect(XMVectorDivide(XMVectorReplicate(QUANTIZED_MAX), size), XMVectorZero(),
+		XMVectorLessOrEqual(size, XMVectorZero()));
+	const XMVECTOR quantizedMax = XMVectorReplicate(QUANTIZED_MAX);
+
+	const XMVECTOR minBound = XMVectorClamp(XMVectorFloor(XMVectorMultiply(XMVectorSubtract(aabb.MinBound(), frame.MinBound()), scale)),
+		XMVectorZero(), quantizedMax);
+	const XMVECTOR maxBound = XMVectorClamp(XMVectorCeiling(XMVectorMultiply(XMVectorSubtract(aabb.MaxBound(), frame.MinBound()), scale)),
+		XMVectorZero(), quantizedMax);
+
+	return { static_cast<std::uint16_t>(XMVectorGetX(minBound)), static_cast<std::uint16_t>(XMVectorGetY(minBound)),
+		static_cast<std::uint16_t>(XMVectorGetX(maxBound)), static_cast<std::uint16_t>(XMVectorGetY(maxBound)) };
+}
+
+void QuadTree::QuantizeItems(const std::size_t nodeIndex) noexcept
+{
+	auto& node = Nodes[nodeIndex];
+	const auto first = Items.begin() + node.FirstItem;
+	const auto last = first + node.ItemCount;
+	if (first == last)
+	{
+		node.ItemBounds = { XMVectorZero(), XMVectorZero() };
+		return;
+	}
+
+	XMVECTOR minBound = _entries[first->Entry].Aabb.MinBound();
+	XMVECTOR maxBound = _entries[first->Entry].Aabb.MaxBound();
+	for (auto item = first; item != last; ++item)
 	{
-		SubdivideNode(node);
-		node.ColliderRefAabbs.push_back(colliderRefAabb);
-		for (const auto& child : node.Children)
+		minBound = XMVectorMin(minBound, _entries[item->Entry].Aabb.MinBound());
+		maxBound = XMVectorMax(maxBound, _entries[item->Entry].Aabb.MaxBound());
+	}
+	node.ItemBounds = { minBound, maxBound };
+
+	for (auto item = first; item != last; ++item)
+	{
+		item->Aabb = Quantize(_entries[item->Entry].Aabb, node.ItemBounds);
+	}
+}
+
+void QuadTree::SplitNode(const std::uint32_t nodeIndex, const std::vector<ColliderRefAabb>& entries) noexcept
+{
+	const std::uint32_t begin = Nodes[nodeIndex].FirstItem;
+	const std::uint32_t count = Nodes[nodeIndex].ItemCount;
+
+	const int depth = Nodes[nodeIndex].Depth;
+	_stats.NodeCount++;
+
+	Nodes[nodeIndex].FirstItem = static_cast<std::uint32_t>(Items.size());
+	if (count <= static_cast<std::uint32_t>(_maxColliders) || depth >= _maxDepth)
+	{
+		for (std::uint32_t i = begin; i < begin + count; ++i)
 		{
-			for (auto& col : node.ColliderRefAabbs)
-			{
-				if (Intersect(col.Aabb, child->Bounds))
-				{
-					Insert(*child, col);
-				}
-			}
+			Items.push_back({ {}, _levelEntries[i] });
 		}
-		node.ColliderRefAabbs.clear();
+		QuantizeItems(nodeIndex);
+
+		_stats.LeafCount++;
+		_stats.MaxLeafItems = std::max<std::size_t>(_stats.MaxLeafItems, count);
+		_stats.OverfullLeafCount += count > static_cast<std::uint32_t>(_maxColliders) ? 1 : 0;
+		_stats.LeafPairs += count > 1 ? static_cast<std::size_t>(count) * (count - 1) / 2 : 0;
+		_stats.Depth = std::max(_stats.Depth, depth);
+		return;
+	}
+
+	SubdivideNode(nodeIndex);
+	const std::size_t firstChild = FirstChild(nodeIndex);
+
+	// Counting pass: the children of each entry, then the range of each child in the next level
+	std::array<std::uint32_t, 4> cursors{};
+	_childMasks.resize(count);
+	for (std::uint32_t i = 0; i < count; ++i)
+	{
+		const std::uint8_t mask = GetChildMask(nodeIndex, entries[_levelEntries[begin + i]].Aabb);
+		_childMasks[i] = mask;
+		for (std::size_t child = 0; child < 4; ++child)
+		{
+			cursors[child] += (mask >> child) & 1u;
+		}
+	}
+
+	auto offset = static_cast<std::uint32_t>(_nextLevelEntries.size());
+	for (std::size_t child = 0; child < 4; ++child)
+	{
+		auto& childNode = Nodes[firstChild + child];
+		childNode.FirstItem = offset;
+		childNode.ItemCount = cursors[child];
+		cursors[child] = offset;
+		offset += childNode.ItemCount;
+		_nextLevelNodes.push_back(static_cast<std::uint32_t>(firstChild + child));
 	}
-	else
+	_nextLevelEntries.resize(offset);
+
+	// Scatter pass, in order, the entries going to no child stay in the node
+	auto& node = Nodes[nodeIndex];
+	node.ItemCount = 0;
+	for (std::uint32_t i = 0; i < count; ++i)
 	{
-		node.ColliderRefAabbs.push_back(colliderRefAabb);
+		const std::uint32_t entryIndex = _levelEntries[begin + i];
+		const std::uint8_t mask = _childMasks[i];
+		if (mask == 0)
+		{
+			Items.push_back({ {}, entryIndex });
+			node.ItemCount++;
+			continue;
+		}
+		for (std::size_t child = 0; child < 4; ++child)
+		{
+			if ((mask >> child) & 1u)
+			{
+				_nextLevelEntries[cursors[child]++] = entryIndex;
+			}
+		}
 	}
+	QuantizeItems(nodeIndex);
 }
 
-void QuadTree::SetUpRoot(const RectangleF& bounds) noexcept
+void QuadTree::Build(const RectangleF& bounds, const std::vector<ColliderRefAabb>& entries) noexcept
 {
 #ifdef TRACY_ENABLE
 	ZoneScoped;
 #endif
-	for (auto& node : Nodes)
+	Items.clear();
+	_entries = entries.data();
+	_stats = QuadTreeStats();
+	_stats.MaxColliders = _maxColliders;
+	_stats.MaxDepth = _maxDepth;
+
+	auto& root = Nodes[0];
+	root.Bounds = bounds;
+	root.LooseBounds = GetLooseBounds(bounds);
+	root.Depth = 0;
+	root.IsLeaf = true;
+	root.FirstItem = 0;
+	root.ItemCount = static_cast<std::uint32_t>(entries.size());
+
+	_levelEntries.resize(entries.size());
+	std::iota(_levelEntries.begin(), _levelEntries.end(), 0u);
+	_levelNodes.assign(1, 0);
+
+	// Level after level, so that the nodes of a level are split before their children
+	while (!_levelNodes.empty())
 	{
-		node.ColliderRefAabbs.clear();
-		std::fill(node.Children.begin(), node.Children.end(), nullptr);
+		_nextLevelEntries.clear();
+		_nextLevelNodes.clear();
+		for (const auto nodeIndex : _levelNodes)
+		{
+			SplitNode(nodeIndex, entries);
+		}
+		std::swap(_levelEntries, _nextLevelEntries);
+		std::swap(_levelNodes, _nextLevelNodes);
 	}
-	Nodes[0].Bounds = bounds;
 
-	_nodeIndex = 1;
+	_stats.ItemCount = Items.size();
+}
+
+void QuadTree::SetLimits(const int maxColliders, const int maxDepth) noexcept
+{
+	_maxColliders = std::max(maxColliders, 1);
+	_maxDepth = std::clamp(maxDepth, 0, MAX_DEPTH_LIMIT);
 }
@@ -0,0 +1,82 @@
+#include "QuadTreeTuner.h"
+
+void QuadTreeTuner::Reset(const QuadTree& tree) noexcept
+{
+	_maxColliders = tree.GetMaxColliders();
+	_maxDepth = tree.GetMaxDepth();
+	_move = 0;
+	_isTrial = false;
+	_stepCount = 0;
+	_costSum = 0.0;
+	_cost = 0.0;
+	_keptMoves = 0;
+}
+
+bool QuadTreeTuner::GetNeighbour(const int move, int& maxColliders, int& maxDepth) const noexcept
+{
+	maxColliders = _maxColliders;
+	maxDepth = _maxDepth;
+
+	switch (move)
+	{
+	case 0:
+		maxColliders *= 2;
+		break;
+	case 1:
+		maxColliders /= 2;
+		break;
+	case 2:
+		maxDepth++;
+		break;
+	default:
+		maxDepth--;
+		break;
+	}
+
+	return maxColliders >= MIN_COLLIDERS && maxColliders <= MAX_COLLIDERS && maxDepth >= MIN_DEPTH && maxDepth <= MAX_DEPTH;
+}
+
+void QuadTreeTuner::Record(QuadTree& tree, const std::size_t pairTests) noexcept
+{
+	_costSum += static_cast<double>(pairTests + tree.GetStats().ItemCount);
+	if (++_stepCount < WINDOW_STEPS)
+	{
+		return;
+	}
+
+	const double cost = _costSum / static_cast<double>(WINDOW_STEPS);
+	_stepCount = 0;
+	_costSum = 0.0;
+
+	if (_isTrial)
+	{
+		_isTrial = false;
+		if (cost < _cost * IMPROVEMENT)
+		{
+			// Keep the neighbour and try the same move again, after measuring it as the current limits
+			_maxColliders = tree.GetMaxColliders();
+			_maxDepth = tree.GetMaxDepth();
+			_keptMoves++;
+			return;
+		}
+
+		tree.SetLimits(_maxColliders, _maxDepth);
+		_move = (_move + 1) % MOVE_COUNT;
+		return;
+	}
+
+	// The scene changes, the current limits are measured again before each neighbour
+	_cost = cost;
+	for (int i = 0; i < MOVE_COUNT; ++i)
+	{
+		int maxColliders = 0;
+		int maxDepth = 0;
+		if (GetNeighbour(_move, maxColliders, maxDepth))
+		{
+			tree.SetLimits(maxColliders, maxDepth);
+			_isTrial = true;
+			return;
+		}
+		_move = (_move + 1) % MOVE_COUNT;
+	}
+}
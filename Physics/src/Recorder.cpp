@@ -0,0 +1,171 @@
+#include "Recorder.h"
+
+#include <cmath>
+#include <stdexcept>
+
+#ifdef TRACY_ENABLE
+#include <Tracy.hpp>
+#endif
+
+QuantizedBody Quantize(const Body& body, const float positionQuantum, const float velocityQuantum) noexcept
+{
+	return {
+		std::llround(XMVectorGetX(body.Position) / positionQuantum),
+		std::llround(XMVectorGetY(body.Position) / positionQuantum),
+		std::llround(XMVectorGetX(body.Velocity) / velocityQuantum),
+		std::llround(XMVectorGetY(body.Velocity) / velocityQuantum)
+	};
+}
+
+Recorder::~Recorder() noexcept
+{
+	if (_file == nullptr)
+	{
+		return;
+	}
+
+	try
+	{
+		Close();
+	}
+	catch (const std::exception&)
+	{
+		// A destructor cannot report the failure, Close must be called to know about it
+	}
+}
+
+void Recorder::Open(const std::string& path, const std::uint32_t keyframeInterval, const float positionQuantum,
+	const float velocityQuantum)
+{
+	if (_file != nullptr)
+	{
+		Close();
+	}
+
+	_file = std::fopen(path.c_str(), "wb");
+	if (_file == nullptr)
+	{
+		throw std::runtime_error("Cannot create " + path + " !");
+	}
+
+	_header = RecordingHeader{ RECORDING_MAGIC, RECORDING_VERSION, Max(keyframeInterval, 1u), 0, positionQuantum,
+		velocityQuantum, 0, 0 };
+	_keyframes.clear();
+	_quantizedBodies.clear();
+	_colliderCount = 0;
+	_isKeyframeRequested = false;
+	_isFailed = std::fwrite(&_header, sizeof(_header), 1, _file) != 1;
+	_offset = sizeof(_header);
+}
+
+void Recorder::Close()
+{
+	if (_file == nullptr)
+	{
+		return;
+	}
+
+	// The index and the counts make the seeks direct, without them the reader scans the frames
+	_header.KeyframeCount = static_cast<std::uint32_t>(_keyframes.size());
+	_header.IndexOffset = _offset;
+	if (!_keyframes.empty() && std::fwrite(_keyframes.data(), sizeof(KeyframeEntry), _keyframes.size(), _file) != _keyframes.size())
+	{
+		_isFailed = true;
+	}
+	if (std::fseek(_file, 0, SEEK_SET) != 0 || std::fwrite(&_header, sizeof(_header), 1, _file) != 1)
+	{
+		_isFailed = true;
+	}
+	if (std::fclose(_file) != 0)
+	{
+		_isFailed = true;
+	}
+	_file = nullptr;
+
+	if (_isFailed)
+	{
+		throw std::runtime_error("Recording write failed !");
+	}
+}
+
+void Recorder::OnUpdate(const World& world) noexcept
+{
+#ifdef TRACY_ENABLE
+	ZoneScoped;
+#endif
+	if (_file == nullptr || _isFailed)
+	{
+		return;
+	}
+
+	const auto& bodies = world.GetBodies();
+	const auto bodyCount = static_cast<std::uint32_t>(bodies.size());
+	const std::uint64_t stateHash = world.StateHash();
+
+	const bool isKeyframe = _isKeyframeRequested || _header.FrameCount % _header.KeyframeInterval == 0
+		|| bodies.size() != _quantizedBodies.size() || world.ColliderGenIndices.size() != _colliderCount;
+
+	if (isKeyframe)
+	{
+		world.Snapshot(_payload);
+		_keyframes.push_back({ _header.FrameCount, _offset });
+		WriteFrame(FrameType::KEYFRAME, bodyCount, stateHash);
+
+		// The deltas restart from the quantized keyframe, exactly what the replayer computes from the snapshot
+		_quantizedBodies.resize(bodies.size());
+		for (std::size_t i = 0; i < bodies.size(); ++i)
+		{
+			_quantizedBodies[i] = Quantize(bodies[i], _header.PositionQuantum, _header.VelocityQuantum);
+		}
+		_colliderCount = world.ColliderGenIndices.size();
+		_isKeyframeRequested = false;
+		return;
+	}
+
+	// Each changed body is written as the gap from the previous changed one, then its four quantized deltas
+	_payload.clear();
+	std::size_t previousIndex = 0;
+	for (std::size_t i = 0; i < bodies.size(); ++i)
+	{
+		const auto quantized = Quantize(bodies[i], _header.PositionQuantum, _header.VelocityQuantum);
+		auto& previous = _quantizedBodies[i];
+		if (quantized == previous)
+		{
+			continue;
+		}
+
+		WriteVarint(i - previousIndex);
+		for (std::size_t j = 0; j < quantized.size(); ++j)
+		{
+			WriteVarint(ZigZagEncode(quantized[j] - previous[j]));
+		}
+		previous = quantized;
+		previousIndex = i;
+	}
+
+	WriteFrame(FrameType::DELTA, bodyCount, stateHash);
+}
+
+void Recorder::WriteFrame(const FrameType type, const std::uint32_t bodyCount, const std::uint64_t stateHash) noexcept
+{
+	const FrameHeader frameHeader{ type, bodyCount, stateHash, _payload.size() };
+	if (std::fwrite(&frameHeader, sizeof(frameHeader), 1, _file) != 1
+		|| (!_payload.empty() && std::fwrite(_payload.data(), 1, _payload.size(), _file) != _payload.size()))
+	{
+		_isFailed = true;
+		return;
+	}
+
+	_offset += sizeof(frameHeader) + _payload.size();
+	_header.FrameCount++;
+}
+
+void Recorder::WriteVarint(std::uint64_t value) noexcept
+{
+	while (value >= 0x80)
+	{
+		_payload.push_back(static_cast<std::uint8_t>(value | 0x80));
+		value >>= 7;
+	}
+	_payload.push_back(static_cast<std::uint8_t>(value));
+}
@@ -0,0 +1,215 @@
+#include "Replayer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#ifdef TRACY_ENABLE
+#include <Tracy.hpp>
+#endif
+
+void Replayer::Open(const std::string& path)
+{
+	Close();
+	_file.Open(path);
+
+	if (_file.Size() < sizeof(RecordingHeader))
+	{
+		Close();
+		throw std::runtime_error(path + " is not a replay file !");
+	}
+	std::memcpy(&_header, _file.Data(), sizeof(_header));
+
+	if (_header.Magic != RECORDING_MAGIC || _header.Version != RECORDING_VERSION)
+	{
+		Close();
+		throw std::runtime_error("Unsupported replay file version in " + path + " !");
+	}
+
+	const std::uint64_t indexSize = static_cast<std::uint64_t>(_header.KeyframeCount) * sizeof(KeyframeEntry);
+	if (_header.IndexOffset == 0 || _header.IndexOffset + indexSize != _file.Size())
+	{
+		ScanFrames();
+		return;
+	}
+
+	_keyframes.resize(_header.KeyframeCount);
+	if (!_keyframes.empty())
+	{
+		std::memcpy(_keyframes.data(), _file.Data() + _header.IndexOffset, indexSize);
+	}
+}
+
+void Replayer::Close() noexcept
+{
+	_file.Close();
+	_header = RecordingHeader{};
+	_keyframes.clear();
+	_quantizedBodies.clear();
+	_frame = 0;
+	_nextOffset = 0;
+	_stateHash = 0;
+}
+
+void Replayer::ScanFrames()
+{
+	// The last frame may have been cut by the interruption, only the complete ones are kept
+	_keyframes.clear();
+	_header.FrameCount = 0;
+
+	std::uint64_t offset = sizeof(RecordingHeader);
+	while (offset + sizeof(FrameHeader) <= _file.Size())
+	{
+		FrameHeader frameHeader{};
+		std::memcpy(&frameHeader, _file.Data() + offset, sizeof(frameHeader));
+		if (frameHeader.PayloadSize > _file.Size() - offset - sizeof(FrameHeader))
+		{
+			break;
+		}
+
+		if (frameHeader.Type == FrameType::KEYFRAME)
+		{
+			_keyframes.push_back({ _header.FrameCount, offset });
+		}
+		offset += sizeof(FrameHeader) + frameHeader.PayloadSize;
+		_header.FrameCount++;
+	}
+
+	_header.KeyframeCount = static_cast<std::uint32_t>(_keyframes.size());
+	_header.IndexOffset = offset;
+}
+
+FrameHeader Replayer::ReadFrameHeader(const std::uint64_t offset) const
+{
+	FrameHeader frameHeader{};
+	if (offset + sizeof(FrameHeader) > _header.IndexOffset)
+	{
+		throw std::runtime_error("Replay frame out of the file !");
+	}
+	std::memcpy(&frameHeader, _file.Data() + offset, sizeof(frameHeader));
+
+	if (frameHeader.PayloadSize > _header.IndexOffset - offset - sizeof(FrameHeader))
+	{
+		throw std::runtime_error("Replay frame out of the file !");
+	}
+	return frameHeader;
+}
+
+void Replayer::Seek(World& world, const std::uint64_t frame)
+{
+#ifdef TRACY_ENABLE
+	ZoneScoped;
+#endif
+	if (frame >= _header.FrameCount || _keyframes.empty())
+	{
+		throw std::runtime_error("No such frame in the replay !");
+	}
+
+	// The world may not be the one restored last or may have been stepped since, the keyframe is always the base
+	const auto keyframe = std::upper_bound(_keyframes.begin(), _keyframes.end(), frame,
+		[](const std::uint64_t value, const KeyframeEntry& entry) { return value < entry.Frame; }) - 1;
+	std::uint64_t offset = keyframe->Offset;
+	for (std::uint64_t current = keyframe->Frame; current <= frame; ++current)
+	{
+		RestoreFrame(world, current, offset);
+		offset = _nextOffset;
+	}
+}
+
+bool Replayer::Next(World& world)
+{
+	if (_nextOffset == 0)
+	{
+		if (_header.FrameCount == 0)
+		{
+			return false;
+		}
+		Seek(world, 0);
+		return true;
+	}
+
+	if (_frame + 1 >= _header.FrameCount)
+	{
+		return false;
+	}
+	RestoreFrame(world, _frame + 1, _nextOffset);
+	return true;
+}
+
+bool Replayer::IsKeyframe() const noexcept
+{
+	return std::binary_search(_keyframes.begin(), _keyframes.end(), KeyframeEntry{ _frame, 0 },
+		[](const KeyframeEntry& entry1, const KeyframeEntry& entry2) { return entry1.Frame < entry2.Frame; });
+}
+
+void Replayer::RestoreFrame(World& world, const std::uint64_t frame, const std::uint64_t offset)
+{
+	const FrameHeader frameHeader = ReadFrameHeader(offset);
+	const std::uint8_t* payload = _file.Data() + offset + sizeof(FrameHeader);
+	const std::uint8_t* payloadEnd = payload + frameHeader.PayloadSize;
+
+	auto& bodies = world.GetBodies();
+
+	if (frameHeader.Type == FrameType::KEYFRAME)
+	{
+		world.Restore(payload, static_cast<std::size_t>(frameHeader.PayloadSize));
+
+		_quantizedBodies.resize(bodies.size());
+		for (std::size_t i = 0; i < bodies.size(); ++i)
+		{
+			_quantizedBodies[i] = Quantize(bodies[i], _header.PositionQuantum, _header.VelocityQuantum);
+		}
+	}
+	else
+	{
+		if (frameHeader.BodyCount != bodies.size() || _quantizedBodies.size() != bodies.size())
+		{
+			throw std::runtime_error("Replay delta frame does not follow the restored frame !");
+		}
+
+		const auto ReadVarint = [&payload, payloadEnd]()
+		{
+			std::uint64_t value = 0;
+			for (int shift = 0; shift < 64; shift += 7)
+			{
+				if (payload == payloadEnd)
+				{
+					break;
+				}
+				const std::uint8_t byte = *payload++;
+				value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+				if ((byte & 0x80) == 0)
+				{
+					return value;
+				}
+			}
+			throw std::runtime_error("Replay delta frame is corrupted !");
+		};
+
+		std::uint64_t index = 0;
+		while (payload != payloadEnd)
+		{
+			index += ReadVarint();
+			if (index >= bodies.size())
+			{
+				throw std::runtime_error("Replay delta frame is corrupted !");
+			}
+
+			auto& quantized = _quantizedBodies[index];
+			for (auto& value : quantized)
+			{
+				value += ZigZagDecode(ReadVarint());
+			}
+
+			auto& body = bodies[index];
+			body.Position = XMVectorSet(static_cast<float>(quantized[0]) * _header.PositionQuantum,
+				static_cast<float>(quantized[1]) * _header.PositionQuantum, 0.f, 0.f);
+			body.Velocity = XMVectorSet(static_cast<float>(quantized[2]) * _header.VelocityQuantum,
+				static_cast<float>(quantized[3]) * _header.VelocityQuantum, 0.f, 0.f);
+		}
+	}
+
+	_frame = frame;
+	_nextOffset = offset + sizeof(FrameHeader) + frameHeader.PayloadSize;
+	_stateHash = frameHeader.StateHash;
+}
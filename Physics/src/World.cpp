@@ -1,14 +1,32 @@
 #include "World.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
 #ifdef TRACY_ENABLE
 #include <Tracy.hpp>
 #include <TracyC.h>
 #endif 
 
+using ProfileClock = std::chrono::high_resolution_clock;
+
+[[nodiscard]] static double ElapsedMs(const ProfileClock::time_point start) noexcept
+{
+	return std::chrono::duration<double, std::milli>(ProfileClock::now() - start).count();
+}
+
 void World::SetUp(int initSize) noexcept
 {
+	initSize = static_cast<int>(Min<std::size_t>(initSize, BodyRef::MAX_COUNT));
+
 	_bodies.resize(initSize);
 	BodyGenIndices.resize(initSize, 0);
+	_bodyColliderCounts.resize(initSize, 0);
 
 	_colliders.resize(initSize);
 	ColliderGenIndices.resize(initSize, 0);
@@ -18,11 +36,36 @@ void World::TearDown() noexcept
 {
 	_bodies.clear();
 	BodyGenIndices.clear();
+	_bodyColliderCounts.clear();
 	_colliders.clear();
+	_shapes.clear();
 
 	ColliderGenIndices.clear();
 
 	_colRefPairs.clear();
+	_contactBodyPairs.clear();
+	_colliderAabbs.clear();
+	_isInStaticTree.clear();
+	_isStaticTreeDirty = true;
+
+	// The queries until the next update must not meet the colliders of the scene torn down
+	_quadTreeEntries.clear();
+	_staticQuadTreeEntries.clear();
+	QuadTree.Build(RectangleF(XMVectorZero(), XMVectorZero()), _quadTreeEntries);
+	StaticQuadTree.Build(RectangleF(XMVectorZero(), XMVectorZero()), _staticQuadTreeEntries);
+
+	_isSleepingEnabled = false;
+	_gravity = XMVectorZero();
+	_linearDamping = 0.f;
+	_forceFields.clear();
+	_hasBounds = false;
+	_bodyExtents.clear();
+
+	// The tuned limits belong to the scene, the static tree kept the ones set by hand
+	QuadTree.SetLimits(StaticQuadTree.GetMaxColliders(), StaticQuadTree.GetMaxDepth());
+	_quadTreeTuner.Reset(QuadTree);
+
+	_accumulator = 0.f;
 }
 
 void World::Update(const float deltaTime) noexcept
@@ -30,14 +73,134 @@ void World::Update(const float deltaTime) noexcept
 #ifdef TRACY_ENABLE
 	ZoneScoped;
 #endif
-	UpdateBodies(deltaTime);
+	_profile = WorldProfile();
+
+	Step(deltaTime, true);
+
+	if (_updateListener != nullptr)
+	{
+		_updateListener->OnUpdate(*this);
+	}
+}
+
+int World::FixedUpdate(const float frameTime) noexcept
+{
+#ifdef TRACY_ENABLE
+	ZoneScoped;
+#endif
+	_profile = WorldProfile();
+	_accumulator += frameTime;
+
+	int stepNbr = 0;
+	while (_accumulator >= _fixedDeltaTime && stepNbr < _maxSubSteps)
+	{
+		_accumulator -= _fixedDeltaTime;
+		stepNbr++;
+
+		// The forces of the frame act on every sub step, the last one clears them
+		const bool isLastStep = _accumulator < _fixedDeltaTime || stepNbr == _maxSubSteps;
+		Step(_fixedDeltaTime, isLastStep);
+
+		if (_updateListener != nullptr)
+		{
+			_updateListener->OnUpdate(*this);
+		}
+	}
+
+	if (stepNbr == 0)
+	{
+		// The forces must not add up with the ones of the next frame
+		ResetForces();
+	}
+	else if (_accumulator >= _fixedDeltaTime)
+	{
+		// Too slow to catch up, drop the time left behind instead of spiraling
+		_accumulator = std::fmod(_accumulator, _fixedDeltaTime);
+	}
+
+	return stepNbr;
+}
+
+void World::SetQuadTreeLimits(const int maxColliders, const int maxDepth) noexcept
+{
+	QuadTree.SetLimits(maxColliders, maxDepth);
+	StaticQuadTree.SetLimits(maxColliders, maxDepth);
+	_quadTreeTuner.Reset(QuadTree);
+	_isStaticTreeDirty = true;
+}
+
+void World::SetQuadTreeTuning(const bool isEnabled) noexcept
+{
+	if (!isEnabled)
+	{
+		// A neighbour may be under measure, go back to the limits found so far
+		QuadTree.SetLimits(_quadTreeTuner.GetMaxColliders(), _quadTreeTuner.GetMaxDepth());
+	}
+	_quadTreeTuner.Reset(QuadTree);
+	_isQuadTreeTuned = isEnabled;
+}
+
+void World::SetFixedTimeStep(const float fixedDeltaTime, const int maxSubSteps) noexcept
+{
+	_fixedDeltaTime = fixedDeltaTime;
+	_maxSubSteps = Max(maxSubSteps, 1);
+	_accumulator = Min(_accumulator, _fixedDeltaTime);
+}
+
+XMVECTOR World::GetInterpolatedPosition(const BodyRef bodyRef)
+{
+	const auto& body = GetBody(bodyRef);
+	return XMVectorLerp(body.PreviousPosition, body.Position, GetInterpolationAlpha());
+}
+
+void World::ResetInterpolation() noexcept
+{
+	for (auto& body : _bodies)
+	{
+		body.PreviousPosition = body.Position;
+	}
+}
+
+void World::Step(const float deltaTime, const bool resetForces) noexcept
+{
+	if (!_isProfilingEnabled)
+	{
+		UpdateBodies(deltaTime, resetForces);
+
+		SetUpQuadTree();
+
+		UpdateCollisions();
+
+		if (_isSleepingEnabled)
+		{
+			UpdateSleep(deltaTime);
+		}
+		return;
+	}
+
+	auto start = ProfileClock::now();
+	UpdateBodies(deltaTime, resetForces);
+	_profile.IntegrateMs += ElapsedMs(start);
 
+	start = ProfileClock::now();
 	SetUpQuadTree();
+	_profile.QuadTreeBuildMs += ElapsedMs(start);
 
-	UpdateQuadTreeCollisions(QuadTree.Nodes[0]);
+	// The solve time is accumulated inside the collision pass, the remaining time is the narrowphase
+	const double solveMs = _profile.SolveMs;
+	start = ProfileClock::now();
+	UpdateCollisions();
+	_profile.NarrowphaseMs += ElapsedMs(start) - (_profile.SolveMs - solveMs);
+
+	if (_isSleepingEnabled)
+	{
+		start = ProfileClock::now();
+		UpdateSleep(deltaTime);
+		_profile.SolveMs += ElapsedMs(start);
+	}
 }
 
-[[nodiscard]] BodyRef World::CreateBody() noexcept
+[[nodiscard]] BodyRef World::CreateBody()
 {
 	const auto it = std::find_if(_bodies.begin(), _bodies.end(), [](const Body& body) {
 		return !body.IsEnabled(); // Get first disabled body
@@ -47,14 +210,25 @@ void World::Update(const float deltaTime) noexcept
 	{
 		const std::size_t index = std::distance(_bodies.begin(), it);
 		const auto bodyRef = BodyRef{ index, BodyGenIndices[index] };
-		GetBody(bodyRef).Enable();
+
+		// A reused slot must not hand the sleep state, velocity or pending force of its former body to the new one
+		auto& body = _bodies[index];
+		body = Body();
+		body.Enable();
 		return bodyRef;
 	}
 
 	const std::size_t previousSize = _bodies.size();
+	if (previousSize >= BodyRef::MAX_COUNT)
+	{
+		throw std::runtime_error("Too many bodies !");
+	}
 
-	_bodies.resize(previousSize * 2, Body());
-	BodyGenIndices.resize(previousSize * 2, 0);
+	// A reference cannot index past MAX_COUNT, the last doubling stops there
+	const std::size_t newSize = Min(Max<std::size_t>(previousSize * 2, 1), BodyRef::MAX_COUNT);
+	_bodies.resize(newSize, Body());
+	BodyGenIndices.resize(newSize, 0);
+	_bodyColliderCounts.resize(newSize, 0);
 
 	const BodyRef bodyRef = { previousSize, BodyGenIndices[previousSize] };
 	GetBody(bodyRef).Enable();
@@ -63,26 +237,40 @@ void World::Update(const float deltaTime) noexcept
 
 void World::DestroyBody(const BodyRef bodyRef)
 {
-	if (BodyGenIndices[bodyRef.Index] != bodyRef.GenIndex)
+	if (!IsValid(bodyRef))
 	{
 		throw std::runtime_error("No body found !");
 	}
 
-	_bodies[bodyRef.Index].Disable();
+	// Colliders left attached would point to whatever body takes the slot next, a body without any skips the scan
+	const auto& colliderCount = _bodyColliderCounts[bodyRef.Index()];
+	for (std::size_t i = 0; i < _colliders.size() && colliderCount > 0; ++i)
+	{
+		if (_colliders[i].IsAttached && _colliders[i].BodyRef == bodyRef)
+		{
+			DestroyCollider(ColliderRef{ i, ColliderGenIndices[i] });
+		}
+	}
+
+	_bodies[bodyRef.Index()].Disable();
+	BodyGenIndices[bodyRef.Index()] = BodyRef::NextGenIndex(BodyGenIndices[bodyRef.Index()]);
 }
 
 [[nodiscard]] Body& World::GetBody(const BodyRef bodyRef)
 {
-	if (BodyGenIndices[bodyRef.Index] != bodyRef.GenIndex)
+	if (!IsValid(bodyRef))
 	{
 		throw std::runtime_error("No body found !");
 	}
 
-	return _bodies[bodyRef.Index];
+	return _bodies[bodyRef.Index()];
 }
 
-ColliderRef World::CreateCollider(const BodyRef bodyRef) noexcept
+ColliderRef World::CreateCollider(const BodyRef bodyRef)
 {
+	// The bounds of the new collider are only computed for awake bodies
+	GetBody(bodyRef).WakeUp();
+
 	const auto it = std::find_if(_colliders.begin(), _colliders.end(), [](const Collider& collider) {
 		return !collider.IsAttached; // Get first disabled collider
 		});
@@ -91,232 +279,1586 @@ ColliderRef World::CreateCollider(const BodyRef bodyRef) noexcept
 	{
 		const std::size_t index = std::distance(_colliders.begin(), it);
 		const auto colRef = ColliderRef{ index, ColliderGenIndices[index] };
+		// A reused slot must not hand the layers, trigger flag or shape of its former collider to the new one
 		auto& col = GetCollider(colRef);
+		col = Collider();
 		col.IsAttached = true;
 		col.BodyRef = bodyRef;
+		_bodyColliderCounts[bodyRef.Index()]++;
 
 		return colRef;
 	}
 
 	const std::size_t previousSize = _colliders.size();
+	if (previousSize >= ColliderRef::MAX_COUNT)
+	{
+		throw std::runtime_error("Too many colliders !");
+	}
 
-	_colliders.resize(previousSize * 2, Collider());
-	ColliderGenIndices.resize(previousSize * 2, 0);
+	// A reference cannot index past MAX_COUNT, the last doubling stops there
+	const std::size_t newSize = Min(Max<std::size_t>(previousSize * 2, 1), ColliderRef::MAX_COUNT);
+	_colliders.resize(newSize, Collider());
+	ColliderGenIndices.resize(newSize, 0);
 
 	const ColliderRef colRef = { previousSize, ColliderGenIndices[previousSize] };
 	auto& col = GetCollider(colRef);
 	col.IsAttached = true;
 	col.BodyRef = bodyRef;
+	_bodyColliderCounts[bodyRef.Index()]++;
 	return colRef;
 }
 
 Collider& World::GetCollider(const ColliderRef colRef)
 {
-	if (ColliderGenIndices[colRef.Index] != colRef.GenIndex)
+	if (!IsValid(colRef))
 	{
 		throw std::runtime_error("No collider found !");
 	}
 
-	return _colliders[colRef.Index];
+	return _colliders[colRef.Index()];
 }
 
 void World::DestroyCollider(const ColliderRef colRef)
 {
-	if (ColliderGenIndices[colRef.Index] != colRef.GenIndex)
+	if (!IsValid(colRef))
 	{
 		throw std::runtime_error("No collider found !");
 	}
-	_colliders[colRef.Index].IsAttached = false;
+
+	// The trigger pairs of the collider would never be tested again
+	for (auto it = _colRefPairs.begin(); it != _colRefPairs.end();)
+	{
+		if (it->ColRefA != colRef && it->ColRefB != colRef)
+		{
+			++it;
+			continue;
+		}
+		if (_contactListener != nullptr)
+		{
+			_contactListener->OnTriggerExit(it->ColRefA, it->ColRefB);
+		}
+		it = _colRefPairs.erase(it);
+	}
+
+	auto& collider = _colliders[colRef.Index()];
+	if (collider.IsAttached)
+	{
+		_bodyColliderCounts[collider.BodyRef.Index()]--;
+	}
+
+	// Detached, the slot also releases the vertices of its shape
+	collider = Collider();
+	ColliderGenIndices[colRef.Index()] = ColliderRef::NextGenIndex(ColliderGenIndices[colRef.Index()]);
+}
+
+std::size_t World::ReserveBodies(const std::size_t count, std::vector<BodyRef>& bodyRefs)
+{
+	// Every body after the last enabled one is free, they are filled before growing
+	std::size_t first = _bodies.size();
+	while (first > 0 && !_bodies[first - 1].IsEnabled())
+	{
+		first--;
+	}
+
+	if (count > BodyRef::MAX_COUNT - first)
+	{
+		throw std::runtime_error("Too many bodies !");
+	}
+
+	if (first + count > _bodies.size())
+	{
+		_bodies.resize(first + count, Body());
+		BodyGenIndices.resize(first + count, 0);
+		_bodyColliderCounts.resize(first + count, 0);
+	}
+
+	bodyRefs.reserve(bodyRefs.size() + count);
+	for (std::size_t i = first; i < first + count; ++i)
+	{
+		_bodies[i] = Body();
+		_bodies[i].Enable();
+		bodyRefs.push_back(BodyRef{ i, BodyGenIndices[i] });
+	}
+
+	return first;
+}
+
+ShapeId World::CreateShape(ColliderShape shape) noexcept
+{
+	_shapes.push_back(std::move(shape));
+	return static_cast<ShapeId>(_shapes.size() - 1);
+}
+
+const ColliderShape& World::GetShape(const ShapeId shapeId) const
+{
+	if (shapeId >= _shapes.size())
+	{
+		throw std::runtime_error("No shape found !");
+	}
+
+	return _shapes[shapeId];
 }
 
-void World::UpdateBodies(const float deltaTime) noexcept
+void World::CreateColliders(const std::vector<BodyRef>& bodyRefs, const ShapeId shapeId, std::vector<ColliderRef>& colRefs,
+	const Collider& prototype)
 {
 #ifdef TRACY_ENABLE
 	ZoneScoped;
 #endif
-	for (auto& body : _bodies)
+	const auto& shape = GetShape(shapeId);
+
+	// Checked first, so that a bad reference leaves no collider behind
+	for (const auto& bodyRef : bodyRefs)
+	{
+		if (!IsValid(bodyRef))
+		{
+			throw std::runtime_error("No body found !");
+		}
+	}
+
+	std::size_t first = _colliders.size();
+	while (first > 0 && !_colliders[first - 1].IsAttached)
+	{
+		first--;
+	}
+
+	const std::size_t count = bodyRefs.size();
+	if (count > ColliderRef::MAX_COUNT - first)
+	{
+		throw std::runtime_error("Too many colliders !");
+	}
+	if (first + count > _colliders.size())
+	{
+		_colliders.resize(first + count, Collider());
+		ColliderGenIndices.resize(first + count, 0);
+	}
+
+	colRefs.reserve(colRefs.size() + count);
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		// The bounds of the new colliders are only computed for awake bodies
+		auto& body = _bodies[bodyRefs[i].Index()];
+		body.WakeUp();
+
+		auto& col = _colliders[first + i];
+		col = prototype;
+		col.Shape = shape;
+		col.BodyRef = bodyRefs[i];
+		col.BodyPosition = body.Position;
+		col.IsAttached = true;
+		_bodyColliderCounts[bodyRefs[i].Index()]++;
+
+		colRefs.push_back(ColliderRef{ first + i, ColliderGenIndices[first + i] });
+	}
+}
+
+void World::UpdateBodies(const float deltaTime, const bool resetForces) noexcept
+{
+#ifdef TRACY_ENABLE
+	ZoneScoped;
+#endif
+	// Damping by 1 / (1 + c dt) cannot reverse the velocities, whatever the time step
+	const float damping = 1.f / (1.f + deltaTime * _linearDamping);
+	const bool hasForceFields = !_forceFields.empty();
+	const auto boundsMin = _bounds.MinBound();
+	const auto boundsMax = _bounds.MaxBound();
+
+	for (std::size_t i = 0; i < _bodies.size(); ++i)
 	{
+		auto& body = _bodies[i];
 		if (!body.IsEnabled())
 		{
 			continue;
 		}
-		if (body.Type == BodyType::STATIC)
+		body.PreviousPosition = body.Position;
+		if (body.Type == BodyType::STATIC || !body.IsAwake())
 		{
 			continue;
 		}
-		auto acceleration = XMVectorScale(body.GetForce(), 1 / body.Mass);
-		body.Velocity = XMVectorAdd(body.Velocity, XMVectorScale(acceleration, deltaTime));
+		auto acceleration = XMVectorAdd(XMVectorScale(body.GetForce(), 1 / body.Mass), _gravity);
+		if (hasForceFields)
+		{
+			acceleration = XMVectorAdd(acceleration, ForceFieldAcceleration(body.Position));
+		}
+		body.Velocity = XMVectorScale(XMVectorAdd(body.Velocity, XMVectorScale(acceleration, deltaTime)), damping);
 		body.Position = XMVectorAdd(body.Position, XMVectorScale(body.Velocity, deltaTime));
 
+		if (_hasBounds)
+		{
+			// Bodies created since the last step are contained as points
+			const auto extents = i < _bodyExtents.size() ? _bodyExtents[i] : RectangleF(XMVectorZero(), XMVectorZero());
+			const auto minBound = XMVectorAdd(body.Position, extents.MinBound());
+			const auto maxBound = XMVectorAdd(body.Position, extents.MaxBound());
+
+			// Both sides of both axes are compared at once, the minimum side wins like in an if else
+			const auto isBelowMin = XMVectorLessOrEqual(minBound, boundsMin);
+			const auto isAboveMax = XMVectorAndCInt(XMVectorGreaterOrEqual(maxBound, boundsMax), isBelowMin);
+
+			const auto speed = XMVectorAbs(body.Velocity);
+			body.Velocity = XMVectorSelect(XMVectorSelect(body.Velocity, speed, isBelowMin), XMVectorNegate(speed), isAboveMax);
+
+			const auto push = XMVectorSelect(XMVectorSelect(XMVectorZero(), XMVectorSubtract(boundsMin, minBound), isBelowMin),
+				XMVectorSubtract(boundsMax, maxBound), isAboveMax);
+			body.Position = XMVectorAdd(body.Position, push);
+		}
+
+		if (resetForces)
+		{
+			body.ResetForce();
+		}
+	}
+}
+
+void World::ResetForces() noexcept
+{
+	for (auto& body : _bodies)
+	{
 		body.ResetForce();
 	}
 }
 
+XMVECTOR World::ForceFieldAcceleration(const XMVECTOR position) const noexcept
+{
+	XMVECTOR acceleration = XMVectorZero();
+
+	for (const auto& field : _forceFields)
+	{
+		switch (field.Type)
+		{
+		case ForceFieldType::POINT:
+		{
+			const auto toCenter = XMVectorSubtract(field.Position, position);
+			const float distance = XMVectorGetX(XMVector2Length(toCenter));
+			if (distance <= 0.f || distance > field.Radius)
+			{
+				break;
+			}
+			// Inverse square of the softened distance, along the normalized direction
+			const float softenedDistance = distance + field.Softening;
+			const float scale = field.Strength / (softenedDistance * softenedDistance * distance);
+			acceleration = XMVectorAdd(acceleration, XMVectorScale(toCenter, scale));
+			break;
+		}
+		case ForceFieldType::ZONE:
+			if (field.Zone.Contains(position))
+			{
+				acceleration = XMVectorAdd(acceleration, field.Acceleration);
+			}
+			break;
+		}
+	}
+
+	return acceleration;
+}
+
 void World::SetUpQuadTree() noexcept {
 #ifdef TRACY_ENABLE
 	ZoneScoped;
 #endif
-	XMVECTOR maxBounds = XMVectorSet(std::numeric_limits<float>::min(), std::numeric_limits<float>::min(), 0, 0);
+	XMVECTOR maxBounds = XMVectorSet(std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(), 0, 0);
 	XMVECTOR minBounds = XMVectorSet(std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), 0, 0);
 
-	for (auto& collider : _colliders) {
+	_colliderAabbs.resize(_colliders.size(), RectangleF(XMVectorZero(), XMVectorZero()));
+	_isInStaticTree.resize(_colliders.size(), false);
+	_quadTreeEntries.clear();
+
+	if (_hasBounds) {
+		_bodyExtents.assign(_bodies.size(), RectangleF(XMVectorZero(), XMVectorZero()));
+	}
+
+	for (std::size_t i = 0; i < _colliders.size(); ++i) {
+		auto& collider = _colliders[i];
+		const bool isStatic = collider.IsAttached && GetBodyUnchecked(collider.BodyRef).Type == BodyType::STATIC;
+
+		// A collider entering or leaving the static colliders changes the static tree
+		if (isStatic != _isInStaticTree[i]) {
+			_isStaticTreeDirty = true;
+		}
 		if (!collider.IsAttached) {
 			continue;
 		}
 
-		collider.BodyPosition = GetBody(collider.BodyRef).Position;
+		const auto& body = GetBodyUnchecked(collider.BodyRef);
 
-		const auto bounds = collider.GetBounds();
+		// Static colliders are only checked for a move, they are in the static tree
+		if (isStatic) {
+			if (XMVector2NotEqual(collider.BodyPosition, body.Position)) {
+				_isStaticTreeDirty = true;
+			}
+			continue;
+		}
 
-		minBounds = XMVectorSetX(minBounds, std::min(XMVectorGetX(minBounds), XMVectorGetX(bounds.MinBound())));
-		minBounds = XMVectorSetY(minBounds, std::min(XMVectorGetY(minBounds), XMVectorGetY(bounds.MinBound())));
-		maxBounds = XMVectorSetX(maxBounds, std::max(XMVectorGetX(maxBounds), XMVectorGetX(bounds.MaxBound())));
-		maxBounds = XMVectorSetY(maxBounds, std::max(XMVectorGetY(maxBounds), XMVectorGetY(bounds.MaxBound())));
-	}
+		const bool isSleeping = !body.IsAwake();
 
-	QuadTree.SetUpRoot(RectangleF(minBounds, maxBounds));
-#ifdef TRACY_ENABLE
-	ZoneNamedN(Insert, "Insert in QuadTree", true);
-#endif
-	for (std::size_t i = 0; i < _colliders.size(); ++i) {
-		if (_colliders[i].IsAttached) {
-			QuadTree.Insert(QuadTree.Nodes[0], { _colliders[i].GetBounds(), { i, ColliderGenIndices[i] } });
+		// A sleeping body keeps its bounds, unless it has been moved by hand
+		if (!isSleeping || XMVector2NotEqual(collider.BodyPosition, body.Position)) {
+			collider.BodyPosition = body.Position;
+			_colliderAabbs[i] = collider.GetBounds();
+		}
+
+		auto bounds = _colliderAabbs[i];
+
+		if (_hasBounds) {
+			auto& extents = _bodyExtents[collider.BodyRef.Index()];
+			extents = RectangleF(XMVectorMin(extents.MinBound(), XMVectorSubtract(bounds.MinBound(), body.Position)),
+				XMVectorMax(extents.MaxBound(), XMVectorSubtract(bounds.MaxBound(), body.Position)));
+		}
+
+		// A continuous body covers its whole move, so that it meets what it went through
+		const bool isContinuous = body.IsContinuous && !isSleeping;
+		if (isContinuous) {
+			const auto move = XMVectorSubtract(body.PreviousPosition, body.Position);
+			bounds = RectangleF(XMVectorMin(bounds.MinBound(), XMVectorAdd(bounds.MinBound(), move)),
+				XMVectorMax(bounds.MaxBound(), XMVectorAdd(bounds.MaxBound(), move)));
 		}
+
+		minBounds = XMVectorMin(minBounds, bounds.MinBound());
+		maxBounds = XMVectorMax(maxBounds, bounds.MaxBound());
+
+		_quadTreeEntries.push_back({ bounds, { i, ColliderGenIndices[i] }, false, isSleeping, isContinuous,
+			collider.IsTrigger, collider.CategoryBits, collider.MaskBits });
+	}
+
+	if (_isStaticTreeDirty) {
+		SetUpStaticQuadTree();
 	}
+
+	QuadTree.Build(RectangleF(minBounds, maxBounds), _quadTreeEntries);
+	_profile.Tree = QuadTree.GetStats();
 }
 
-void World::UpdateQuadTreeCollisions(const QuadNode& node) noexcept
-{
+void World::SetUpStaticQuadTree() noexcept {
 #ifdef TRACY_ENABLE
 	ZoneScoped;
 #endif
-	if (node.Children[0] == nullptr)
-	{
-		if (node.ColliderRefAabbs.empty())
-		{
-			return;
+	XMVECTOR maxBounds = XMVectorSet(std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(), 0, 0);
+	XMVECTOR minBounds = XMVectorSet(std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), 0, 0);
+
+	_staticQuadTreeEntries.clear();
+
+	for (std::size_t i = 0; i < _colliders.size(); ++i) {
+		auto& collider = _colliders[i];
+		_isInStaticTree[i] = collider.IsAttached && GetBodyUnchecked(collider.BodyRef).Type == BodyType::STATIC;
+		if (!_isInStaticTree[i]) {
+			continue;
 		}
-		for (std::size_t i = 0; i < node.ColliderRefAabbs.size() - 1; ++i)
-		{
-			auto& col1 = GetCollider(node.ColliderRefAabbs[i].ColRef);
 
-			for (std::size_t j = i + 1; j < node.ColliderRefAabbs.size(); ++j)
-			{
-				auto& col2 = GetCollider(node.ColliderRefAabbs[j].ColRef);
+		collider.BodyPosition = GetBodyUnchecked(collider.BodyRef).Position;
+		_colliderAabbs[i] = collider.GetBounds();
+		const auto& bounds = _colliderAabbs[i];
 
-				if (!col2.IsTrigger && !col1.IsTrigger) // Physical collision
-				{
-					if (Overlap(col1, col2))
-					{
-						Contact contact;
-						contact.CollidingBodies[0] = { &GetBody(col1.BodyRef), &col1 };
-						contact.CollidingBodies[1] = { &GetBody(col2.BodyRef), &col2 };
-						contact.Resolve();
-						if (_contactListener != nullptr)
-						{
-							_contactListener->OnCollisionEnter(node.ColliderRefAabbs[i].ColRef, node.ColliderRefAabbs[j].ColRef);
-						}
-					}
-					else
-					{
-						if (_contactListener != nullptr)
-						{
-							_contactListener->OnCollisionExit(node.ColliderRefAabbs[i].ColRef, node.ColliderRefAabbs[j].ColRef);
-						}
-					}
-					continue;
-				}
+		minBounds = XMVectorMin(minBounds, bounds.MinBound());
+		maxBounds = XMVectorMax(maxBounds, bounds.MaxBound());
 
-				if (_contactListener == nullptr)
-				{
-					continue;
-				}
-				// Trigger collision
-				const ColliderRefPair& colPair = { node.ColliderRefAabbs[i].ColRef, node.ColliderRefAabbs[j].ColRef };
+		_staticQuadTreeEntries.push_back({ bounds, { i, ColliderGenIndices[i] }, true, false, false,
+			collider.IsTrigger, collider.CategoryBits, collider.MaskBits });
+	}
 
-				if (_colRefPairs.find(colPair) != _colRefPairs.end())
-				{
-					if (!Overlap(col1, col2))
-					{
-						_contactListener->OnTriggerExit(colPair.ColRefA, colPair.ColRefB);
-						_colRefPairs.erase(colPair);
-					}
-					continue;
-				}
+	StaticQuadTree.Build(RectangleF(minBounds, maxBounds), _staticQuadTreeEntries);
 
-				if (Overlap(col1, col2))
-				{
-					_contactListener->OnTriggerEnter(colPair.ColRefA, colPair.ColRefB);
-					_colRefPairs.emplace(colPair);
-				}
-			}
-		}
+	_isStaticTreeDirty = false;
+}
+
+void World::SetSleepingEnabled(const bool isEnabled) noexcept
+{
+	_isSleepingEnabled = isEnabled;
+	if (isEnabled)
+	{
+		return;
 	}
-	else
+
+	for (auto& body : _bodies)
 	{
-		for (const auto& child : node.Children)
+		if (!body.IsAwake())
 		{
-			UpdateQuadTreeCollisions(*child);
+			body.WakeUp();
 		}
 	}
+	_contactBodyPairs.clear();
 }
 
-[[nodiscard]] bool World::Overlap(const Collider& colA, const Collider& colB) noexcept
+std::size_t World::FindIsland(std::size_t bodyIndex) noexcept
 {
-	const auto ShapeA = static_cast<ShapeType>(colA.Shape.index());
-	const auto ShapeB = static_cast<ShapeType>(colB.Shape.index());
+	while (_islandParents[bodyIndex] != bodyIndex)
+	{
+		// Path halving, every visited body points to its grandparent
+		_islandParents[bodyIndex] = _islandParents[_islandParents[bodyIndex]];
+		bodyIndex = _islandParents[bodyIndex];
+	}
+	return bodyIndex;
+}
 
+void World::UpdateSleep(const float deltaTime) noexcept
+{
 #ifdef TRACY_ENABLE
 	ZoneScoped;
-	/*static constexpr const char* names[] = { "Circle", "Rectangle", "Polygon", "None" };
-	const auto log = fmt::format("Shape A: {}, Shape B: {}", names[static_cast<int>(ShapeA)], names[static_cast<int>(ShapeB)]);
-	ZoneText(log.data(), log.size());*/
 #endif
-
-	switch (ShapeA)
+	_islandParents.resize(_bodies.size());
+	for (std::size_t i = 0; i < _islandParents.size(); ++i)
 	{
-	case ShapeType::Circle:
+		_islandParents[i] = i;
+	}
+
+	for (const auto& [bodyIndexA, bodyIndexB] : _contactBodyPairs)
 	{
-		CircleF circle = std::get<CircleF>(colA.Shape) + GetBody(colA.BodyRef).Position;
-		switch (ShapeB)
+		const auto rootA = FindIsland(bodyIndexA);
+		const auto rootB = FindIsland(bodyIndexB);
+		if (rootA != rootB)
 		{
-		case ShapeType::Circle:
-			return Intersect(circle, std::get<CircleF>(colB.Shape) + GetBody(colB.BodyRef).Position);
-		case ShapeType::Rectangle:
-			return Intersect(circle, std::get<RectangleF>(colB.Shape) + GetBody(colB.BodyRef).Position);
-			case ShapeType::Polygon:
-				return Intersect(circle, std::get<PolygonF>(colB.Shape) + GetBody(colB.BodyRef).Position);
+			_islandParents[rootB] = rootA;
 		}
-		break;
 	}
-	case ShapeType::Rectangle:
+	_contactBodyPairs.clear();
+
+	// An island can only sleep once its most recently moving body rested long enough
+	const float sleepVelocitySq = _sleepVelocity * _sleepVelocity;
+	_islandSleepTimes.assign(_bodies.size(), std::numeric_limits<float>::max());
+
+	for (std::size_t i = 0; i < _bodies.size(); ++i)
 	{
-		RectangleF rect = std::get<RectangleF>(colA.Shape) + GetBody(colA.BodyRef).Position;
-		switch (ShapeB)
+		auto& body = _bodies[i];
+		if (!body.IsEnabled() || body.Type == BodyType::STATIC || !body.IsAwake())
+		{
+			continue;
+		}
+
+		if (XMVectorGetX(XMVector3LengthSq(body.Velocity)) > sleepVelocitySq)
+		{
+			body.SleepTime = 0.f;
+		}
+		else
 		{
-		case ShapeType::Circle:
-			return Intersect(rect, std::get<CircleF>(colB.Shape) + GetBody(colB.BodyRef).Position);
-		case ShapeType::Rectangle:
-			return Intersect(rect, std::get<RectangleF>(colB.Shape) + GetBody(colB.BodyRef).Position);
-			case ShapeType::Polygon:
-				return Intersect(rect, std::get<PolygonF>(colB.Shape) + GetBody(colB.BodyRef).Position);
+			body.SleepTime += deltaTime;
 		}
-		break;
+
+		auto& islandSleepTime = _islandSleepTimes[FindIsland(i)];
+		islandSleepTime = std::min(islandSleepTime, body.SleepTime);
 	}
-	case ShapeType::Polygon:
+
+	for (std::size_t i = 0; i < _bodies.size(); ++i)
 	{
-		PolygonF pol = std::get<PolygonF>(colA.Shape) + GetBody(colA.BodyRef).Position;
-		switch (ShapeB)
+		auto& body = _bodies[i];
+		if (!body.IsEnabled() || body.Type == BodyType::STATIC || !body.IsAwake())
 		{
-		case ShapeType::Circle:
-			return Intersect(pol, std::get<CircleF>(colB.Shape) + GetBody(colB.BodyRef).Position);
-		case ShapeType::Rectangle:
-			return Intersect(pol, std::get<RectangleF>(colB.Shape) + GetBody(colB.BodyRef).Position);
-		case ShapeType::Polygon:
-			return Intersect(pol, std::get<PolygonF>(colB.Shape) + GetBody(colB.BodyRef).Position);
+			continue;
 		}
-		break;
-	}
+
+		if (_islandSleepTimes[FindIsland(i)] >= _timeToSleep)
+		{
+			body.Sleep();
+		}
+	}
+}
+
+void World::UpdateQuadTreeCollisions(const std::size_t nodeIndex) noexcept
+{
+#ifdef TRACY_ENABLE
+	ZoneScoped;
+#endif
+	const auto& node = QuadTree.Nodes[nodeIndex];
+	if (node.IsLeaf)
+	{
+		const auto entries = QuadTree.GetItems(node);
+		for (auto it1 = entries.begin(); it1 != entries.end(); ++it1)
+		{
+			const auto& entry1 = *it1;
+			Collider* col1Ptr = nullptr;
+
+			auto it2 = it1;
+			for (++it2; it2 != entries.end(); ++it2)
+			{
+				const auto& entry2 = *it2;
+				if (IsPairFiltered(entry1, entry2))
+				{
+					continue;
+				}
+				if (_isDeterministic)
+				{
+					AddPotentialPair(entry1, entry2);
+					continue;
+				}
+
+				if (col1Ptr == nullptr)
+				{
+					col1Ptr = &GetColliderUnchecked(entry1.ColRef);
+				}
+				TestPair(entry1, *col1Ptr, entry2);
+			}
+		}
+	}
+	else
+	{
+		const std::size_t firstChild = ::QuadTree::FirstChild(nodeIndex);
+		for (std::size_t child = firstChild; child < firstChild + 4; ++child)
+		{
+			UpdateQuadTreeCollisions(child);
+		}
+	}
+}
+
+void World::UpdateLooseQuadTreeCollisions() noexcept
+{
+#ifdef TRACY_ENABLE
+	ZoneScoped;
+#endif
+	for (const auto& entry1 : _quadTreeEntries)
+	{
+		Collider* col1Ptr = nullptr;
+
+		ForEachNode(QuadTree, 0, entry1.Aabb, [&](const QuadNodeItems& entries)
+			{
+				for (const auto& entry2 : entries)
+				{
+					// Each collider is stored once, the pair is met once from each side
+					if (entry2.ColRef.Index() <= entry1.ColRef.Index() || !Intersect(entry1.Aabb, entry2.Aabb)
+						|| IsPairFiltered(entry1, entry2))
+					{
+						continue;
+					}
+					if (_isDeterministic)
+					{
+						AddPotentialPair(entry1, entry2);
+						continue;
+					}
+
+					if (col1Ptr == nullptr)
+					{
+						col1Ptr = &GetColliderUnchecked(entry1.ColRef);
+					}
+					TestPair(entry1, *col1Ptr, entry2);
+				}
+			});
+	}
+}
+
+void World::UpdateCollisions() noexcept
+{
+#ifdef TRACY_ENABLE
+	ZoneScoped;
+#endif
+	_potentialPairs.clear();
+	const std::size_t pairTests = _profile.PairTests;
+
+	if (QuadTree.IsLoose())
+	{
+		UpdateLooseQuadTreeCollisions();
+	}
+	else
+	{
+		UpdateQuadTreeCollisions(0);
+	}
+	UpdateStaticCollisions();
+
+	if (_isDeterministic)
+	{
+		TestPotentialPairs();
+	}
+
+	if (_isQuadTreeTuned)
+	{
+		_quadTreeTuner.Record(QuadTree, _profile.PairTests - pairTests);
+	}
+}
+
+void World::AddPotentialPair(const ColliderRefAabb& entry1, const ColliderRefAabb& entry2) noexcept
+{
+	const auto index1 = static_cast<std::uint64_t>(entry1.ColRef.Index());
+	const auto index2 = static_cast<std::uint64_t>(entry2.ColRef.Index());
+	if (index1 < index2)
+	{
+		_potentialPairs.push_back({ &entry1, &entry2, index1 << 32 | index2 });
+	}
+	else
+	{
+		_potentialPairs.push_back({ &entry2, &entry1, index2 << 32 | index1 });
+	}
+}
+
+void World::TestPotentialPairs() noexcept
+{
+#ifdef TRACY_ENABLE
+	ZoneScoped;
+#endif
+	// Sorting by collider indices removes any dependence on the QuadTree shape, and the duplicates
+	// of the colliders spanning several leaves end up next to each other
+	std::sort(_potentialPairs.begin(), _potentialPairs.end(), [](const PotentialPair& pair1, const PotentialPair& pair2)
+		{
+			return pair1.Key < pair2.Key;
+		});
+	const auto end = std::unique(_potentialPairs.begin(), _potentialPairs.end(), [](const PotentialPair& pair1, const PotentialPair& pair2)
+		{
+			return pair1.Key == pair2.Key;
+		});
+	_potentialPairs.erase(end, _potentialPairs.end());
+
+	for (const auto& pair : _potentialPairs)
+	{
+		TestPair(*pair.Entry1, GetColliderUnchecked(pair.Entry1->ColRef), *pair.Entry2);
 	}
+}
+
+std::uint64_t World::StateHash() const noexcept
+{
+#ifdef TRACY_ENABLE
+	ZoneScoped;
+#endif
+	static constexpr std::uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+	static constexpr std::uint64_t FNV_PRIME = 1099511628211ull;
+
+	std::uint64_t hash = FNV_OFFSET_BASIS;
+	const auto HashBytes = [&hash](const void* data, const std::size_t size)
+	{
+		const auto* bytes = static_cast<const unsigned char*>(data);
+		for (std::size_t i = 0; i < size; ++i)
+		{
+			hash = (hash ^ bytes[i]) * FNV_PRIME;
+		}
+	};
+	const auto HashFloat = [&HashBytes](const float value)
+	{
+		// The bits are hashed, a desync of a single ulp changes the hash
+		std::uint32_t bits = 0;
+		std::memcpy(&bits, &value, sizeof(bits));
+		HashBytes(&bits, sizeof(bits));
+	};
+
+	const auto bodyCount = static_cast<std::uint64_t>(_bodies.size());
+	HashBytes(&bodyCount, sizeof(bodyCount));
+
+	// Only the x and y lanes of the vectors are part of the state
+	for (const auto& body : _bodies)
+	{
+		HashFloat(XMVectorGetX(body.Position));
+		HashFloat(XMVectorGetY(body.Position));
+		HashFloat(XMVectorGetX(body.Velocity));
+		HashFloat(XMVectorGetY(body.Velocity));
+		HashFloat(body.Mass);
+		HashFloat(body.SleepTime);
+
+		const std::uint8_t flags = static_cast<std::uint8_t>(static_cast<std::uint8_t>(body.Type) << 1 | (body.IsAwake() ? 1 : 0));
+		HashBytes(&flags, sizeof(flags));
+	}
+
+	return hash;
+}
+
+/**
+ * @brief Header of a snapshot, followed by the bodies, the generation indices, the colliders, the polygon vertices
+ * and the trigger pairs.
+ */
+struct SnapshotHeader
+{
+	std::uint32_t Magic; /**< Identifies a snapshot. */
+	std::uint32_t Version; /**< Version of the layout. */
+	std::uint64_t BodyCount; /**< Number of bodies and body generation indices. */
+	std::uint64_t ColliderCount; /**< Number of colliders and collider generation indices. */
+	std::uint64_t VertexCount; /**< Number of vertices of every polygon. */
+	std::uint64_t TriggerPairCount; /**< Number of overlapping trigger pairs. */
+	float Accumulator; /**< Time accumulated by the fixed steps. */
+};
+
+/**
+ * @brief Flat collider of a snapshot, its polygon vertices are stored apart.
+ */
+struct SnapshotCollider
+{
+	XMVECTOR ShapeBounds[2]; /**< Center and radius of a circle, bounds of a rectangle, or center then half size and rotation of an oriented rectangle. */
+	XMVECTOR BodyPosition; /**< Position of the body when the collider bounds were computed. */
+	BodyRef BodyRef; /**< Reference to the body of the collider. */
+	std::uint64_t FirstVertex; /**< Index of the first vertex of a polygon. */
+	std::uint64_t VertexCount; /**< Number of vertices of a polygon. */
+	float Restitution; /**< Bounciness of the collider. */
+	std::uint32_t CategoryBits; /**< Layers of the collider. */
+	std::uint32_t MaskBits; /**< Layers the collider collides with. */
+	std::uint32_t ShapeIndex; /**< Index of the shape alternative. */
+	bool IsTrigger; /**< Flag indicating if the collider is a trigger. */
+	bool IsAttached; /**< Flag indicating if the collider is attached to a body. */
+};
+
+static_assert(std::is_trivially_copyable_v<Body>, "Bodies are copied as bytes in the snapshots");
+static_assert(std::is_trivially_copyable_v<ColliderRefPair>, "Trigger pairs are copied as bytes in the snapshots");
+
+void World::Snapshot(std::vector<std::uint8_t>& buffer) const noexcept
+{
+#ifdef TRACY_ENABLE
+	ZoneScoped;
+#endif
+	// Colliders created from the same prototype follow each other, their shared vertices are written once
+	std::size_t vertexCount = 0;
+	const PolygonF* previousPolygon = nullptr;
+	for (const auto& collider : _colliders)
+	{
+		if (const auto* polygon = std::get_if<PolygonF>(&collider.Shape))
+		{
+			if (previousPolygon == nullptr || !polygon->SharesVertices(*previousPolygon))
+			{
+				vertexCount += polygon->VerticesCount();
+			}
+			previousPolygon = polygon;
+		}
+	}
+
+	const SnapshotHeader header{ SNAPSHOT_MAGIC, SNAPSHOT_VERSION, _bodies.size(), _colliders.size(), vertexCount,
+		_colRefPairs.size(), _accumulator };
+
+	buffer.resize(sizeof(SnapshotHeader)
+		+ _bodies.size() * (sizeof(Body) + sizeof(std::uint32_t))
+		+ _colliders.size() * (sizeof(SnapshotCollider) + sizeof(std::uint32_t))
+		+ vertexCount * sizeof(XMVECTOR)
+		+ _colRefPairs.size() * sizeof(ColliderRefPair));
+
+	std::uint8_t* cursor = buffer.data();
+	const auto Write = [&cursor](const void* data, const std::size_t size)
+	{
+		if (size > 0)
+		{
+			std::memcpy(cursor, data, size);
+			cursor += size;
+		}
+	};
+
+	Write(&header, sizeof(header));
+	Write(_bodies.data(), _bodies.size() * sizeof(Body));
+	Write(BodyGenIndices.data(), BodyGenIndices.size() * sizeof(std::uint32_t));
+	Write(ColliderGenIndices.data(), ColliderGenIndices.size() * sizeof(std::uint32_t));
+
+	// The vertices follow the colliders, written behind them as the polygons are met
+	std::uint8_t* vertexCursor = cursor + _colliders.size() * sizeof(SnapshotCollider);
+	std::uint64_t firstVertex = 0;
+	previousPolygon = nullptr;
+	for (const auto& collider : _colliders)
+	{
+		SnapshotCollider record{};
+		record.BodyPosition = collider.BodyPosition;
+		record.BodyRef = collider.BodyRef;
+		record.Restitution = collider.Restitution;
+		record.CategoryBits = collider.CategoryBits;
+		record.MaskBits = collider.MaskBits;
+		record.ShapeIndex = static_cast<std::uint32_t>(collider.Shape.index());
+		record.IsTrigger = collider.IsTrigger;
+		record.IsAttached = collider.IsAttached;
+
+		switch (collider.Shape.index())
+		{
+		case static_cast<int>(ShapeType::Circle):
+		{
+			const auto& circle = std::get<CircleF>(collider.Shape);
+			record.ShapeBounds[0] = circle.Center();
+			record.ShapeBounds[1] = XMVectorReplicate(circle.Radius());
+			break;
+		}
+		case static_cast<int>(ShapeType::Rectangle):
+		{
+			const auto& rectangle = std::get<RectangleF>(collider.Shape);
+			record.ShapeBounds[0] = rectangle.MinBound();
+			record.ShapeBounds[1] = rectangle.MaxBound();
+			break;
+		}
+		case static_cast<int>(ShapeType::Polygon):
+		{
+			const auto& polygon = std::get<PolygonF>(collider.Shape);
+			const auto& vertices = polygon.Vertices();
+			record.VertexCount = vertices.size();
+			if (previousPolygon != nullptr && polygon.SharesVertices(*previousPolygon))
+			{
+				record.FirstVertex = firstVertex - vertices.size();
+			}
+			else
+			{
+				record.FirstVertex = firstVertex;
+				std::memcpy(vertexCursor, vertices.data(), vertices.size() * sizeof(XMVECTOR));
+				vertexCursor += vertices.size() * sizeof(XMVECTOR);
+				firstVertex += vertices.size();
+			}
+			previousPolygon = &polygon;
+			break;
+		}
+		case static_cast<int>(ShapeType::OrientedRectangle):
+		{
+			const auto& rectangle = std::get<OrientedRectangleF>(collider.Shape);
+			record.ShapeBounds[0] = rectangle.Center();
+			record.ShapeBounds[1] = XMVectorSet(XMVectorGetX(rectangle.HalfSize()), XMVectorGetY(rectangle.HalfSize()), rectangle.Cos(), rectangle.Sin());
+			break;
+		}
+		default:
+			break;
+		}
+
+		Write(&record, sizeof(record));
+	}
+
+	cursor = vertexCursor;
+	for (const auto& pair : _colRefPairs)
+	{
+		Write(&pair, sizeof(pair));
+	}
+}
+
+void World::Restore(const std::uint8_t* data, const std::size_t size)
+{
+#ifdef TRACY_ENABLE
+	ZoneScoped;
+#endif
+	SnapshotHeader header{};
+	if (data == nullptr || size < sizeof(header))
+	{
+		throw std::runtime_error("Snapshot too small !");
+	}
+	std::memcpy(&header, data, sizeof(header));
+
+	if (header.Magic != SNAPSHOT_MAGIC || header.Version != SNAPSHOT_VERSION)
+	{
+		throw std::runtime_error("Unsupported snapshot version !");
+	}
+
+	// Each count is bounded by the bytes left before being multiplied, so that a corrupt header cannot wrap the size
+	std::size_t remainingSize = size - sizeof(SnapshotHeader);
+	const auto Consume = [&remainingSize](const std::uint64_t count, const std::size_t recordSize)
+	{
+		if (count > remainingSize / recordSize)
+		{
+			return false;
+		}
+		remainingSize -= static_cast<std::size_t>(count) * recordSize;
+		return true;
+	};
+	if (!Consume(header.BodyCount, sizeof(Body) + sizeof(std::uint32_t))
+		|| !Consume(header.ColliderCount, sizeof(SnapshotCollider) + sizeof(std::uint32_t))
+		|| !Consume(header.VertexCount, sizeof(XMVECTOR))
+		|| !Consume(header.TriggerPairCount, sizeof(ColliderRefPair))
+		|| remainingSize != 0)
+	{
+		throw std::runtime_error("Snapshot size does not match its header !");
+	}
+	if (header.BodyCount > BodyRef::MAX_COUNT || header.ColliderCount > ColliderRef::MAX_COUNT)
+	{
+		throw std::runtime_error("Snapshot has more slots than a reference can index !");
+	}
+
+	// Every record is checked before the world is touched, so that a corrupt snapshot leaves the world as it was
+	const std::uint8_t* const records = data + sizeof(header)
+		+ header.BodyCount * (sizeof(Body) + sizeof(std::uint32_t)) + header.ColliderCount * sizeof(std::uint32_t);
+	for (std::size_t i = 0; i < header.ColliderCount; ++i)
+	{
+		SnapshotCollider record{};
+		std::memcpy(&record, records + i * sizeof(SnapshotCollider), sizeof(record));
+		if (record.ShapeIndex >= std::variant_size_v<ColliderShape>)
+		{
+			throw std::runtime_error("Unknown shape in snapshot !");
+		}
+		if (record.VertexCount > header.VertexCount || record.FirstVertex > header.VertexCount - record.VertexCount)
+		{
+			throw std::runtime_error("Snapshot polygon out of its vertices !");
+		}
+		// The step follows the body references of the colliders without checking them
+		if (record.IsAttached && record.BodyRef.Index() >= header.BodyCount)
+		{
+			throw std::runtime_error("Snapshot collider out of its bodies !");
+		}
+	}
+
+	const std::uint8_t* const triggerPairs = records + header.ColliderCount * sizeof(SnapshotCollider) + header.VertexCount * sizeof(XMVECTOR);
+	for (std::size_t i = 0; i < header.TriggerPairCount; ++i)
+	{
+		ColliderRefPair pair{};
+		std::memcpy(&pair, triggerPairs + i * sizeof(ColliderRefPair), sizeof(pair));
+		if (pair.ColRefA.Index() >= header.ColliderCount || pair.ColRefB.Index() >= header.ColliderCount)
+		{
+			throw std::runtime_error("Snapshot trigger pair out of its colliders !");
+		}
+	}
+
+	const std::uint8_t* cursor = data + sizeof(header);
+	const auto Read = [&cursor](void* destination, const std::size_t readSize)
+	{
+		if (readSize > 0)
+		{
+			std::memcpy(destination, cursor, readSize);
+			cursor += readSize;
+		}
+	};
+
+	_bodies.resize(header.BodyCount);
+	BodyGenIndices.resize(header.BodyCount);
+	_bodyColliderCounts.assign(header.BodyCount, 0);
+	_colliders.resize(header.ColliderCount);
+	ColliderGenIndices.resize(header.ColliderCount);
+
+	Read(_bodies.data(), _bodies.size() * sizeof(Body));
+	Read(BodyGenIndices.data(), BodyGenIndices.size() * sizeof(std::uint32_t));
+	Read(ColliderGenIndices.data(), ColliderGenIndices.size() * sizeof(std::uint32_t));
+
+	const std::uint8_t* vertices = cursor + header.ColliderCount * sizeof(SnapshotCollider);
+	_colliderAabbs.resize(_colliders.size(), RectangleF(XMVectorZero(), XMVectorZero()));
+
+	const PolygonF* previousPolygon = nullptr;
+	std::uint64_t previousFirstVertex = 0;
+	for (std::size_t i = 0; i < _colliders.size(); ++i)
+	{
+		SnapshotCollider record{};
+		Read(&record, sizeof(record));
+
+		auto& collider = _colliders[i];
+		switch (record.ShapeIndex)
+		{
+		case static_cast<int>(ShapeType::Circle):
+			collider.Shape = CircleF(record.ShapeBounds[0], XMVectorGetX(record.ShapeBounds[1]));
+			break;
+		case static_cast<int>(ShapeType::Rectangle):
+			collider.Shape = RectangleF(record.ShapeBounds[0], record.ShapeBounds[1]);
+			break;
+		case static_cast<int>(ShapeType::Polygon):
+		{
+			// Only the polygons own memory, the other shapes are restored without allocating
+			if (previousPolygon != nullptr && previousFirstVertex == record.FirstVertex
+				&& static_cast<std::uint64_t>(previousPolygon->VerticesCount()) == record.VertexCount)
+			{
+				// Vertices written once for several colliders are shared again
+				collider.Shape = *previousPolygon;
+			}
+			else
+			{
+				std::vector<XMVECTOR> polygonVertices(record.VertexCount);
+				std::memcpy(polygonVertices.data(), vertices + record.FirstVertex * sizeof(XMVECTOR), record.VertexCount * sizeof(XMVECTOR));
+				collider.Shape = PolygonF(std::move(polygonVertices));
+			}
+			previousPolygon = &std::get<PolygonF>(collider.Shape);
+			previousFirstVertex = record.FirstVertex;
+			break;
+		}
+		case static_cast<int>(ShapeType::OrientedRectangle):
+			collider.Shape = OrientedRectangleF(record.ShapeBounds[0], record.ShapeBounds[1],
+				XMVectorGetZ(record.ShapeBounds[1]), XMVectorGetW(record.ShapeBounds[1]));
+			break;
+		default:
+			break;
+		}
+
+		collider.BodyPosition = record.BodyPosition;
+		collider.BodyRef = record.BodyRef;
+		collider.Restitution = record.Restitution;
+		collider.CategoryBits = record.CategoryBits;
+		collider.MaskBits = record.MaskBits;
+		collider.IsTrigger = record.IsTrigger;
+		collider.IsAttached = record.IsAttached;
+		if (collider.IsAttached)
+		{
+			_bodyColliderCounts[collider.BodyRef.Index()]++;
+		}
+
+		// Sleeping bodies keep these bounds, computed at the position they were saved with
+		_colliderAabbs[i] = collider.GetBounds();
+	}
+
+	cursor = vertices + header.VertexCount * sizeof(XMVECTOR);
+	_colRefPairs.clear();
+	for (std::size_t i = 0; i < header.TriggerPairCount; ++i)
+	{
+		ColliderRefPair pair{};
+		Read(&pair, sizeof(pair));
+		_colRefPairs.emplace(pair);
+	}
+
+	_accumulator = header.Accumulator;
+	_contactBodyPairs.clear();
+
+	SetUpRestoredQuadTrees();
+}
+
+void World::SetUpRestoredQuadTrees() noexcept
+{
+#ifdef TRACY_ENABLE
+	ZoneScoped;
+#endif
+	XMVECTOR maxBounds = XMVectorSet(std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(), 0, 0);
+	XMVECTOR minBounds = XMVectorSet(std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), 0, 0);
+	XMVECTOR staticMaxBounds = maxBounds;
+	XMVECTOR staticMinBounds = minBounds;
+
+	_isInStaticTree.assign(_colliders.size(), false);
+	_quadTreeEntries.clear();
+	_staticQuadTreeEntries.clear();
+
+	if (_hasBounds)
+	{
+		_bodyExtents.assign(_bodies.size(), RectangleF(XMVectorZero(), XMVectorZero()));
+	}
+
+	// The restored bounds are used as they are, so that the colliders keep the positions they were saved with
+	for (std::size_t i = 0; i < _colliders.size(); ++i)
+	{
+		const auto& collider = _colliders[i];
+		if (!collider.IsAttached)
+		{
+			continue;
+		}
+
+		const auto& body = GetBodyUnchecked(collider.BodyRef);
+		const auto& bounds = _colliderAabbs[i];
+		const ColliderRef colRef{ i, ColliderGenIndices[i] };
+
+		if (body.Type == BodyType::STATIC)
+		{
+			_isInStaticTree[i] = true;
+			staticMinBounds = XMVectorMin(staticMinBounds, bounds.MinBound());
+			staticMaxBounds = XMVectorMax(staticMaxBounds, bounds.MaxBound());
+			_staticQuadTreeEntries.push_back({ bounds, colRef, true, false, false,
+				collider.IsTrigger, collider.CategoryBits, collider.MaskBits });
+			continue;
+		}
+
+		if (_hasBounds)
+		{
+			auto& extents = _bodyExtents[collider.BodyRef.Index()];
+			extents = RectangleF(XMVectorMin(extents.MinBound(), XMVectorSubtract(bounds.MinBound(), collider.BodyPosition)),
+				XMVectorMax(extents.MaxBound(), XMVectorSubtract(bounds.MaxBound(), collider.BodyPosition)));
+		}
+
+		minBounds = XMVectorMin(minBounds, bounds.MinBound());
+		maxBounds = XMVectorMax(maxBounds, bounds.MaxBound());
+		_quadTreeEntries.push_back({ bounds, colRef, false, !body.IsAwake(), false,
+			collider.IsTrigger, collider.CategoryBits, collider.MaskBits });
+	}
+
+	StaticQuadTree.Build(RectangleF(staticMinBounds, staticMaxBounds), _staticQuadTreeEntries);
+	QuadTree.Build(RectangleF(minBounds, maxBounds), _quadTreeEntries);
+
+	// The next step still rebuilds the static tree, from the positions of the bodies
+	_isStaticTreeDirty = true;
+}
+
+void World::UpdateStaticCollisions() noexcept
+{
+#ifdef TRACY_ENABLE
+	ZoneScoped;
+#endif
+	if (_staticQuadTreeEntries.empty())
+	{
+		return;
+	}
+
+	for (const auto& entry1 : _quadTreeEntries)
+	{
+		Collider* col1Ptr = nullptr;
+
+		// A static collider spanning several leaves is met once per moving collider
+		BeginQuery();
+		ForEachNode(StaticQuadTree, 0, entry1.Aabb, [&](const QuadNodeItems& entries)
+			{
+				for (const auto& entry2 : entries)
+				{
+					if (!Intersect(entry1.Aabb, entry2.Aabb) || !MarkQueried(entry2.ColRef) || IsPairFiltered(entry1, entry2))
+					{
+						continue;
+					}
+					if (_isDeterministic)
+					{
+						AddPotentialPair(entry1, entry2);
+						continue;
+					}
+
+					if (col1Ptr == nullptr)
+					{
+						col1Ptr = &GetColliderUnchecked(entry1.ColRef);
+					}
+					TestPair(entry1, *col1Ptr, entry2);
+				}
+			});
+	}
+}
+
+bool World::IsPairFiltered(const ColliderRefAabb& entry1, const ColliderRefAabb& entry2) const noexcept
+{
+	// Pairs are rejected from the entries alone, before reading the colliders and bodies
+	if ((entry1.CategoryBits & entry2.MaskBits) == 0 || (entry2.CategoryBits & entry1.MaskBits) == 0)
+	{
+		return true;
+	}
+
+	// Static and sleeping bodies cannot start touching each other
+	if ((entry1.IsSleeping || entry1.IsStatic) && (entry2.IsSleeping || entry2.IsStatic))
+	{
+		return true;
+	}
+
+	// Nobody listens to trigger events
+	return (entry1.IsTrigger || entry2.IsTrigger) && _contactListener == nullptr;
+}
+
+void World::TestPair(const ColliderRefAabb& entry1, Collider& col1, const ColliderRefAabb& entry2) noexcept
+{
+	auto& col2 = GetColliderUnchecked(entry2.ColRef);
+	_profile.PairTests++;
+
+	const bool isSwept = entry1.IsContinuous || entry2.IsContinuous;
+
+	if (!col2.IsTrigger && !col1.IsTrigger) // Physical collision
+	{
+		if (Overlap(col1, col2) || (isSwept && SweepToImpact(entry1, entry2, true)))
+		{
+			auto& body1 = GetBodyUnchecked(col1.BodyRef);
+			auto& body2 = GetBodyUnchecked(col2.BodyRef);
+			if (_isSleepingEnabled)
+			{
+				WakeOnContact(body1, body2);
+				if (body1.Type != BodyType::STATIC && body2.Type != BodyType::STATIC)
+				{
+					_contactBodyPairs.emplace_back(col1.BodyRef.Index(), col2.BodyRef.Index());
+				}
+			}
+
+			Contact contact;
+			contact.CollidingBodies[0] = { &body1, &col1 };
+			contact.CollidingBodies[1] = { &body2, &col2 };
+			if (_isProfilingEnabled)
+			{
+				const auto start = ProfileClock::now();
+				contact.Resolve();
+				_profile.SolveMs += ElapsedMs(start);
+			}
+			else
+			{
+				contact.Resolve();
+			}
+			_profile.Contacts++;
+			if (_contactListener != nullptr)
+			{
+				_contactListener->OnCollisionEnter(entry1.ColRef, entry2.ColRef);
+			}
+		}
+		else
+		{
+			if (_contactListener != nullptr)
+			{
+				_contactListener->OnCollisionExit(entry1.ColRef, entry2.ColRef);
+			}
+		}
+		return;
+	}
+
+	if (_contactListener == nullptr)
+	{
+		return;
+	}
+	// Trigger collision
+	const ColliderRefPair& colPair = { entry1.ColRef, entry2.ColRef };
+
+	if (_colRefPairs.find(colPair) != _colRefPairs.end())
+	{
+		// A trigger crossed within the step is still left
+		if (!Overlap(col1, col2))
+		{
+			_contactListener->OnTriggerExit(colPair.ColRefA, colPair.ColRefB);
+			_colRefPairs.erase(colPair);
+		}
+		return;
+	}
+
+	if (Overlap(col1, col2) || (isSwept && SweepToImpact(entry1, entry2, false)))
+	{
+		_contactListener->OnTriggerEnter(colPair.ColRefA, colPair.ColRefB);
+		_colRefPairs.emplace(colPair);
+	}
+}
+
+bool World::SweepToImpact(const ColliderRefAabb& entry1, const ColliderRefAabb& entry2, const bool moveToImpact) noexcept
+{
+#ifdef TRACY_ENABLE
+	ZoneScoped;
+#endif
+	const auto& col1 = GetColliderUnchecked(entry1.ColRef);
+	const auto& col2 = GetColliderUnchecked(entry2.ColRef);
+	auto& body1 = GetBodyUnchecked(col1.BodyRef);
+	auto& body2 = GetBodyUnchecked(col2.BodyRef);
+
+	const auto end1 = body1.Position;
+	const auto end2 = body2.Position;
+	const auto start1 = entry1.IsContinuous ? body1.PreviousPosition : end1;
+	const auto start2 = entry2.IsContinuous ? body2.PreviousPosition : end2;
+
+	const auto MoveTo = [&](const float t)
+	{
+		body1.Position = XMVectorLerp(start1, end1, t);
+		body2.Position = XMVectorLerp(start2, end2, t);
+	};
+
+	// Sub steps shorter than half the smaller collider cannot jump over the other one
+	const auto relativeMove = XMVectorSubtract(XMVectorSubtract(end1, start1), XMVectorSubtract(end2, start2));
+	const float moveLength = XMVectorGetX(XMVector2Length(relativeMove));
+	const auto size1 = _colliderAabbs[entry1.ColRef.Index()].Size();
+	const auto size2 = _colliderAabbs[entry2.ColRef.Index()].Size();
+	const float minExtent = std::min({ XMVectorGetX(size1), XMVectorGetY(size1), XMVectorGetX(size2), XMVectorGetY(size2) });
+	const float stepLength = std::max(minExtent / 2.f, std::numeric_limits<float>::epsilon());
+	const int subStepCount = Clamp(static_cast<int>(std::ceil(moveLength / stepLength)), 1, MAX_SWEEP_SUB_STEPS);
+
+	// The end of the step has already been tested
+	float freeT = 0.f;
+	for (int i = 1; i < subStepCount; ++i)
+	{
+		const float t = static_cast<float>(i) / static_cast<float>(subStepCount);
+		MoveTo(t);
+		if (!Overlap(col1, col2))
+		{
+			freeT = t;
+			continue;
+		}
+
+		float hitT = t;
+		for (int j = 0; j < SWEEP_BISECTION_STEPS; ++j)
+		{
+			const float midT = (freeT + hitT) / 2.f;
+			MoveTo(midT);
+			if (Overlap(col1, col2))
+			{
+				hitT = midT;
+			}
+			else
+			{
+				freeT = midT;
+			}
+		}
+
+		// The rest of the move is dropped, the contact resolution changes the velocity anyway
+		if (moveToImpact)
+		{
+			MoveTo(hitT);
+		}
+		else
+		{
+			body1.Position = end1;
+			body2.Position = end2;
+		}
+		return true;
+	}
+
+	body1.Position = end1;
+	body2.Position = end2;
 	return false;
 }
+
+const Collider* World::GetQueryCollider(const ColliderRefAabb& entry, const std::uint32_t layerMask) noexcept
+{
+	if ((entry.CategoryBits & layerMask) == 0)
+	{
+		return nullptr;
+	}
+
+	const auto& colRef = entry.ColRef;
+	if (!IsValid(colRef))
+	{
+		return nullptr;
+	}
+
+	const auto& collider = _colliders[colRef.Index()];
+	if (!collider.IsAttached || (collider.CategoryBits & layerMask) == 0)
+	{
+		return nullptr;
+	}
+	return &collider;
+}
+
+void World::BeginQuery() noexcept
+{
+	_queryStamps.resize(_colliders.size(), 0);
+	if (++_queryStamp == 0)
+	{
+		std::fill(_queryStamps.begin(), _queryStamps.end(), 0);
+		_queryStamp = 1;
+	}
+}
+
+bool World::MarkQueried(const ColliderRef colRef) noexcept
+{
+	// The trees keep the entries of the last step, the world may have shrunk or been restored since
+	if (!IsValid(colRef))
+	{
+		return false;
+	}
+
+	auto& stamp = _queryStamps[colRef.Index()];
+	if (stamp == _queryStamp)
+	{
+		return false;
+	}
+	stamp = _queryStamp;
+	return true;
+}
+
+void World::RayCastNode(const ::QuadTree& tree, const std::size_t nodeIndex, const Ray& ray, const std::uint32_t layerMask, RayCastHit& hit) noexcept
+{
+	const auto& node = tree.Nodes[nodeIndex];
+	const float maxDistance = hit.IsHit ? hit.Distance : ray.MaxDistance;
+
+	float distance = 0.f;
+	XMVECTOR normal = XMVectorZero();
+	if (!::RayCast(node.LooseBounds, ray.Origin, ray.Direction, maxDistance, distance, normal))
+	{
+		return;
+	}
+
+	// Only the leaves of a tight tree hold entries, every node of a loose one may
+	if (!node.IsLeaf)
+	{
+		const std::size_t firstChild = ::QuadTree::FirstChild(nodeIndex);
+		for (std::size_t child = firstChild; child < firstChild + 4; ++child)
+		{
+			RayCastNode(tree, child, ray, layerMask, hit);
+		}
+	}
+
+	for (const auto& entry : tree.GetItems(node))
+	{
+		const float closest = hit.IsHit ? hit.Distance : ray.MaxDistance;
+		if (!::RayCast(entry.Aabb, ray.Origin, ray.Direction, closest, distance, normal))
+		{
+			continue;
+		}
+
+		const auto* collider = GetQueryCollider(entry, layerMask);
+		if (collider == nullptr)
+		{
+			continue;
+		}
+
+		const auto& position = _bodies[collider->BodyRef.Index()].Position;
+		if (::RayCast(collider->Shape, position, ray.Origin, ray.Direction, closest, distance, normal)
+			&& (!hit.IsHit || distance < hit.Distance))
+		{
+			hit.ColRef = entry.ColRef;
+			hit.Distance = distance;
+			hit.Normal = normal;
+			hit.IsHit = true;
+		}
+	}
+}
+
+bool World::RayCast(const Ray& ray, RayCastHit& hit, const std::uint32_t layerMask) noexcept
+{
+	hit = RayCastHit();
+	if (XMVector2Equal(ray.Direction, XMVectorZero()))
+	{
+		return false;
+	}
+
+	RayCastNode(QuadTree, 0, ray, layerMask, hit);
+	if (!_staticQuadTreeEntries.empty())
+	{
+		RayCastNode(StaticQuadTree, 0, ray, layerMask, hit);
+	}
+	if (hit.IsHit)
+	{
+		hit.Point = XMVectorAdd(ray.Origin, XMVectorScale(ray.Direction, hit.Distance));
+	}
+	return hit.IsHit;
+}
+
+bool World::RayCast(const XMVECTOR origin, const XMVECTOR direction, const float maxDistance, RayCastHit& hit,
+	const std::uint32_t layerMask) noexcept
+{
+#ifdef TRACY_ENABLE
+	ZoneScoped;
+#endif
+	return RayCast(Ray{ origin, XMVector2Normalize(direction), maxDistance }, hit, layerMask);
+}
+
+std::size_t World::RayCasts(const Ray* rays, const std::size_t rayCount, RayCastHit* hits, const std::uint32_t layerMask) noexcept
+{
+#ifdef TRACY_ENABLE
+	ZoneScoped;
+#endif
+	// Ray casts only read the world, every thread writes its own hits
+	const auto CastRange = [this, rays, hits, layerMask](const std::size_t begin, const std::size_t end)
+	{
+		std::size_t hitCount = 0;
+		for (std::size_t i = begin; i < end; ++i)
+		{
+			const Ray ray{ rays[i].Origin, XMVector2Normalize(rays[i].Direction), rays[i].MaxDistance };
+			hitCount += RayCast(ray, hits[i], layerMask) ? 1 : 0;
+		}
+		return hitCount;
+	};
+
+	const std::size_t chunkCount = std::max<std::size_t>(1, std::min(_threadPool.GetThreadCount(), rayCount / MIN_RAYS_PER_THREAD));
+	const std::size_t chunkSize = (rayCount + chunkCount - 1) / chunkCount;
+
+	std::atomic<std::size_t> hitCount{ 0 };
+	_threadPool.Run(chunkCount, [&](const std::size_t chunk)
+		{
+			const std::size_t begin = chunk * chunkSize;
+			hitCount.fetch_add(CastRange(begin, std::min(begin + chunkSize, rayCount)), std::memory_order_relaxed);
+		});
+
+	return hitCount.load(std::memory_order_relaxed);
+}
+
+std::size_t World::QueryAabb(const RectangleF& aabb, ColliderRef* results, const std::size_t capacity, const std::uint32_t layerMask) noexcept
+{
+#ifdef TRACY_ENABLE
+	ZoneScoped;
+#endif
+	BeginQuery();
+	const ColliderShape area = aabb;
+	std::size_t count = 0;
+
+	ForEachNode(aabb, [&](const QuadNodeItems& entries)
+		{
+			for (const auto& entry : entries)
+			{
+				if (count >= capacity)
+				{
+					return;
+				}
+				if (!Intersect(entry.Aabb, aabb) || !MarkQueried(entry.ColRef))
+				{
+					continue;
+				}
+
+				const auto* collider = GetQueryCollider(entry, layerMask);
+				if (collider != nullptr && ::Overlap(area, XMVectorZero(), collider->Shape, _bodies[collider->BodyRef.Index()].Position))
+				{
+					results[count++] = entry.ColRef;
+				}
+			}
+		});
+
+	return count;
+}
+
+std::size_t World::QueryPoint(const XMVECTOR point, ColliderRef* results, const std::size_t capacity, const std::uint32_t layerMask) noexcept
+{
+#ifdef TRACY_ENABLE
+	ZoneScoped;
+#endif
+	BeginQuery();
+	const RectangleF area(point, point);
+	std::size_t count = 0;
+
+	ForEachNode(area, [&](const QuadNodeItems& entries)
+		{
+			for (const auto& entry : entries)
+			{
+				if (count >= capacity)
+				{
+					return;
+				}
+				if (!entry.Aabb.Contains(point) || !MarkQueried(entry.ColRef))
+				{
+					continue;
+				}
+
+				const auto* collider = GetQueryCollider(entry, layerMask);
+				if (collider != nullptr && ::Contains(collider->Shape, _bodies[collider->BodyRef.Index()].Position, point))
+				{
+					results[count++] = entry.ColRef;
+				}
+			}
+		});
+
+	return count;
+}
+
+bool World::ShapeCast(const ColliderShape& shape, const XMVECTOR position, const XMVECTOR direction, const float maxDistance,
+	ShapeCastHit& hit, const std::uint32_t layerMask) noexcept
+{
+#ifdef TRACY_ENABLE
+	ZoneScoped;
+#endif
+	hit = ShapeCastHit();
+	if (XMVector2Equal(direction, XMVectorZero()))
+	{
+		return false;
+	}
+
+	const auto unitDirection = XMVector2Normalize(direction);
+	const auto bounds = ::GetBounds(shape, position);
+	const auto move = XMVectorScale(unitDirection, maxDistance);
+	const RectangleF sweptBounds(XMVectorMin(bounds.MinBound(), XMVectorAdd(bounds.MinBound(), move)),
+		XMVectorMax(bounds.MaxBound(), XMVectorAdd(bounds.MaxBound(), move)));
+
+	BeginQuery();
+
+	ForEachNode(sweptBounds, [&](const QuadNodeItems& entries)
+		{
+			for (const auto& entry : entries)
+			{
+				if (!Intersect(entry.Aabb, sweptBounds) || !MarkQueried(entry.ColRef))
+				{
+					continue;
+				}
+
+				// The shape bounds only touch the entry bounds along this part of the move
+				const auto expanded = RectangleF(XMVectorSubtract(entry.Aabb.MinBound(), bounds.HalfSize()),
+					XMVectorAdd(entry.Aabb.MaxBound(), bounds.HalfSize()));
+				const float closest = hit.IsHit ? hit.Distance : maxDistance;
+				float enter = 0.f;
+				XMVECTOR normal = XMVectorZero();
+				if (!::RayCast(expanded, bounds.Center(), unitDirection, closest, enter, normal))
+				{
+					continue;
+				}
+
+				const auto* collider = GetQueryCollider(entry, layerMask);
+				if (collider == nullptr)
+				{
+					continue;
+				}
+
+				const auto& colliderPosition = _bodies[collider->BodyRef.Index()].Position;
+				const auto OverlapAt = [&](const float distance)
+				{
+					return ::Overlap(shape, XMVectorAdd(position, XMVectorScale(unitDirection, distance)), collider->Shape, colliderPosition);
+				};
+
+				// Sub steps shorter than half the smaller shape, then bisection like the continuous collisions
+				const float exit = Min(closest, enter + XMVectorGetX(XMVector2Length(expanded.Size())));
+				const float minExtent = std::min({ XMVectorGetX(bounds.Size()), XMVectorGetY(bounds.Size()),
+					XMVectorGetX(entry.Aabb.Size()), XMVectorGetY(entry.Aabb.Size()) });
+				const float stepLength = std::max(minExtent / 2.f, std::numeric_limits<float>::epsilon());
+				const int subStepCount = Clamp(static_cast<int>(std::ceil((exit - enter) / stepLength)), 1, MAX_SWEEP_SUB_STEPS);
+
+				float freeDistance = enter;
+				for (int i = 0; i <= subStepCount; ++i)
+				{
+					const float distance = enter + (exit - enter) * static_cast<float>(i) / static_cast<float>(subStepCount);
+					if (!OverlapAt(distance))
+					{
+						freeDistance = distance;
+						continue;
+					}
+
+					float hitDistance = distance;
+					if (i > 0)
+					{
+						for (int j = 0; j < SWEEP_BISECTION_STEPS; ++j)
+						{
+							const float midDistance = (freeDistance + hitDistance) / 2.f;
+							if (OverlapAt(midDistance))
+							{
+								hitDistance = midDistance;
+							}
+							else
+							{
+								freeDistance = midDistance;
+							}
+						}
+					}
+
+					hit.ColRef = entry.ColRef;
+					hit.Distance = hitDistance;
+					hit.IsHit = true;
+					break;
+				}
+			}
+		});
+
+	if (hit.IsHit)
+	{
+		hit.Position = XMVectorAdd(position, XMVectorScale(unitDirection, hit.Distance));
+	}
+	return hit.IsHit;
+}
+
+bool World::Overlap(const Collider& colA, const Collider& colB) noexcept
+{
+	return ::Overlap(colA.Shape, GetBodyUnchecked(colA.BodyRef).Position, colB.Shape, GetBodyUnchecked(colB.BodyRef).Position);
+}
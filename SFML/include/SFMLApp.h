@@ -4,16 +4,50 @@
 #include <imgui.h>
 
 #include <SFML/Graphics.hpp>
+#include <array>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 #include "SampleManager.h"
+#include "TripleBuffer.h"
+
+// Copy of what a simulated frame needs to be drawn, owned by the renderer
+struct RenderFrame {
+  std::vector<RenderItem> Items;
+  std::vector<ColliderShape> Shapes;
+  std::uint64_t SampleVersion = 0;  // Sample set up the shapes were copied from
+};
 
 class SFMLApp {
  private:
+  static constexpr int CIRCLE_SEGMENTS = 30;
+
   sf::RenderWindow _window;
   sf::Clock _deltaClock;
   SampleManager _sampleManager;
 
+  // Every shape of a frame is batched in these arrays, drawn with one call each,
+  // their capacity is kept from one frame to the next
+  sf::VertexArray _triangles{sf::Triangles};
+  sf::VertexArray _lines{sf::Lines};
+
+  std::array<sf::Vector2f, CIRCLE_SEGMENTS> _unitCircle;  // Circle vertices of radius 1
+
+  // Frames handed from the simulation to the rendering without locking
+  TripleBuffer<RenderFrame> _renderFrames;
+
+  // In pipelined mode the next frame is simulated on this thread while the
+  // current one is drawn, the sample is only touched by the main thread while
+  // no simulation is requested
+  std::thread _simulationThread;
+  std::mutex _simulationMutex;
+  std::condition_variable _simulationCondition;
+  bool _isSimulationRequested = false;
+  bool _isSimulationStopping = false;
+  bool _isPipelined = true;
+
  public:
   std::string Title;
   int Width, Height;
@@ -28,22 +62,31 @@ class SFMLApp {
 
   void SetUp();
 
-  void TearDown() const noexcept;
+  void TearDown() noexcept;
 
   void Run() noexcept;
 
  private:
-  void DrawCircle(XMVECTOR center, float radius, int segments,
-                  const sf::Color &col) noexcept;
+  void AppendCircle(sf::Vector2f center, sf::Vector2f radius,
+                    const sf::Color &col) noexcept;
+
+  void AppendRectangle(sf::Vector2f minBound, sf::Vector2f maxBound,
+                       const sf::Color &col) noexcept;
+
+  void AppendRectangleBorder(sf::Vector2f minBound, sf::Vector2f maxBound,
+                             const sf::Color &col) noexcept;
 
-  void DrawRectangle(XMVECTOR minBound, XMVECTOR maxBound,
+  void AppendPolygon(const XMVECTOR *vertices, std::size_t vertexCount,
+                     sf::Vector2f position, sf::Vector2f scale,
                      const sf::Color &col) noexcept;
 
-  void DrawRectangleBorder(XMVECTOR minBound, XMVECTOR maxBound,
-                           const sf::Color &col) noexcept;
+  void SimulationLoop() noexcept;
+
+  void RequestSimulation() noexcept;
+
+  void WaitForSimulation() noexcept;
 
-  void DrawPolygon(const std::vector<XMVECTOR> &vertices,
-                   const sf::Color &col);
+  void SimulateFrame() noexcept;
 
-  void DrawAllGraphicsData() noexcept;
+  void DrawAllGraphicsData(const RenderFrame &frame) noexcept;
 };
\ No newline at end of file
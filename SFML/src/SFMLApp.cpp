@@ -1,5 +1,7 @@
 #include "SFMLApp.h"
 
+#include <cmath>
+
 #ifdef TRACY_ENABLE
 #include "Tracy.hpp"
 #include "TracyC.h"
@@ -9,10 +11,29 @@ void SFMLApp::SetUp() {
 	_window.create(sf::VideoMode(Width, Height), Title);
 	ImGui::SFML::Init(_window);
 
+	// Same points as sf::CircleShape, starting at the top
+	for (std::size_t i = 0; i < _unitCircle.size(); ++i) {
+		const float angle = static_cast<float>(i) * XM_2PI / static_cast<float>(_unitCircle.size()) - XM_PIDIV2;
+		_unitCircle[i] = sf::Vector2f(std::cos(angle), std::sin(angle));
+	}
+
 	_sampleManager.SetUp();
+
+	_simulationThread = std::thread([this]() { SimulationLoop(); });
 }
 
-void SFMLApp::TearDown() const noexcept { ImGui::SFML::Shutdown(); }
+void SFMLApp::TearDown() noexcept {
+	{
+		std::lock_guard lock(_simulationMutex);
+		_isSimulationStopping = true;
+	}
+	_simulationCondition.notify_all();
+	if (_simulationThread.joinable()) {
+		_simulationThread.join();
+	}
+
+	ImGui::SFML::Shutdown();
+}
 
 void SFMLApp::Run() noexcept {
 	bool quit = false;
@@ -22,6 +43,9 @@ void SFMLApp::Run() noexcept {
 	sf::Event e;
 
 	while (!quit) {
+		// The frame requested last loop must be done before the events change the sample
+		WaitForSimulation();
+
 		while (_window.pollEvent(e)) {
 			ImGui::SFML::ProcessEvent(e);
 			switch (e.type) {
@@ -102,6 +126,10 @@ void SFMLApp::Run() noexcept {
 			_sampleManager.NextSample();
 		}
 
+		ImGui::SameLine();
+
+		ImGui::Checkbox("Pipelined", &_isPipelined);
+
 		ImGui::End();
 
 		_window.clear(sf::Color::Black);
@@ -109,9 +137,17 @@ void SFMLApp::Run() noexcept {
 		sf::Vector2i sfMousePos = sf::Mouse::getPosition(_window);
 		MousePos = XMVectorSet(sfMousePos.x, sfMousePos.y, 0, 0);
 		_sampleManager.GiveMousePositionToSample(MousePos);
-		_sampleManager.UpdateSample();
 
-		DrawAllGraphicsData();
+		if (_isPipelined) {
+			// The next frame is simulated while the last published one is drawn
+			RequestSimulation();
+		}
+		else {
+			SimulateFrame();
+		}
+
+		_renderFrames.Acquire();
+		DrawAllGraphicsData(_renderFrames.Front());
 
 		ImGui::SFML::Render(_window);
 
@@ -121,115 +157,175 @@ void SFMLApp::Run() noexcept {
 		FrameMark;
 #endif
 	}
+
+	WaitForSimulation();
 }
 
-void SFMLApp::DrawCircle(const XMVECTOR center, const float radius,
-	const int segments, const sf::Color& col) noexcept {
-#ifdef TRACY_ENABLE
-	ZoneScoped;
-#endif
+void SFMLApp::SimulationLoop() noexcept {
+	std::unique_lock lock(_simulationMutex);
+
+	while (true) {
+		_simulationCondition.wait(lock, [this]() { return _isSimulationRequested || _isSimulationStopping; });
+		if (_isSimulationStopping) {
+			return;
+		}
 
-	sf::CircleShape circle = sf::CircleShape(radius, segments);
-	circle.setFillColor(col);
-	circle.setOrigin(radius, radius);
-	circle.setPosition(XMVectorGetX(center), XMVectorGetY(center));
+		lock.unlock();
+		SimulateFrame();
+		lock.lock();
 
-	_window.draw(circle);
+		_isSimulationRequested = false;
+		_simulationCondition.notify_all();
+	}
 }
 
-void SFMLApp::DrawRectangle(const XMVECTOR minBound,
-	const XMVECTOR maxBound,
-	const sf::Color& col) noexcept {
+void SFMLApp::RequestSimulation() noexcept {
+	{
+		std::lock_guard lock(_simulationMutex);
+		_isSimulationRequested = true;
+	}
+	_simulationCondition.notify_all();
+}
+
+void SFMLApp::WaitForSimulation() noexcept {
+	std::unique_lock lock(_simulationMutex);
+	_simulationCondition.wait(lock, [this]() { return !_isSimulationRequested; });
+}
+
+void SFMLApp::SimulateFrame() noexcept {
 #ifdef TRACY_ENABLE
 	ZoneScoped;
 #endif
+	_sampleManager.UpdateSample();
 
-	// Calculate the width and height of the rectangle
-	float width = XMVectorGetX(maxBound) - XMVectorGetX(minBound);
-	float height = XMVectorGetY(maxBound) - XMVectorGetY(minBound);
+	auto& frame = _renderFrames.Back();
+	const auto& items = _sampleManager.GetRenderItems();
+	const auto& shapes = _sampleManager.GetRenderShapes();
 
-	// Create an SFML rectangle shape
-	sf::RectangleShape rectangle(sf::Vector2f(width, height));
+	// The items are plain values, assigning them keeps the capacity of the frame
+	frame.Items.assign(items.begin(), items.end());
 
-	// Set the position and color of the rectangle
-	rectangle.setPosition(XMVectorGetX(minBound), XMVectorGetY(minBound));
-	rectangle.setFillColor(col);
+	// The shapes of a sample are only appended, a frame copies the new ones
+	// and copies all of them again when another sample is set up
+	if (frame.SampleVersion != _sampleManager.GetSampleVersion() || frame.Shapes.size() > shapes.size()) {
+		frame.Shapes.assign(shapes.begin(), shapes.end());
+		frame.SampleVersion = _sampleManager.GetSampleVersion();
+	}
+	else {
+		frame.Shapes.insert(frame.Shapes.end(), shapes.begin() + frame.Shapes.size(), shapes.end());
+	}
 
-	// Draw the rectangle to the window
-	_window.draw(rectangle);
+	_renderFrames.Publish();
 }
 
-void SFMLApp::DrawRectangleBorder(const XMVECTOR minBound, const XMVECTOR maxBound,
+void SFMLApp::AppendCircle(const sf::Vector2f center, const sf::Vector2f radius,
 	const sf::Color& col) noexcept {
-	// Calculate the width and height of the rectangle
-	float width = XMVectorGetX(maxBound) - XMVectorGetX(minBound);
-	float height = XMVectorGetY(maxBound) - XMVectorGetY(minBound);
-
-	// Create an SFML rectangle shape
-	sf::RectangleShape rectangle(sf::Vector2f(width, height));
+	// A fan of triangles around the center
+	for (std::size_t i = 0; i < _unitCircle.size(); ++i) {
+		const auto& point = _unitCircle[i];
+		const auto& nextPoint = _unitCircle[(i + 1) % _unitCircle.size()];
+		_triangles.append(sf::Vertex(center, col));
+		_triangles.append(sf::Vertex(center + sf::Vector2f(point.x * radius.x, point.y * radius.y), col));
+		_triangles.append(sf::Vertex(center + sf::Vector2f(nextPoint.x * radius.x, nextPoint.y * radius.y), col));
+	}
+}
 
-	// Set the position and color of the rectangle
-	rectangle.setPosition(XMVectorGetX(minBound), XMVectorGetY(minBound));
-	rectangle.setOutlineColor(col);
-	rectangle.setOutlineThickness(1);
-	rectangle.setFillColor(sf::Color::Transparent);
+void SFMLApp::AppendRectangle(const sf::Vector2f minBound,
+	const sf::Vector2f maxBound,
+	const sf::Color& col) noexcept {
+	const sf::Vector2f topRight(maxBound.x, minBound.y);
+	const sf::Vector2f bottomLeft(minBound.x, maxBound.y);
+
+	_triangles.append(sf::Vertex(minBound, col));
+	_triangles.append(sf::Vertex(topRight, col));
+	_triangles.append(sf::Vertex(maxBound, col));
+	_triangles.append(sf::Vertex(minBound, col));
+	_triangles.append(sf::Vertex(maxBound, col));
+	_triangles.append(sf::Vertex(bottomLeft, col));
+}
 
-	// Draw the rectangle to the window
-	_window.draw(rectangle);
+void SFMLApp::AppendRectangleBorder(const sf::Vector2f minBound, const sf::Vector2f maxBound,
+	const sf::Color& col) noexcept {
+	const sf::Vector2f topRight(maxBound.x, minBound.y);
+	const sf::Vector2f bottomLeft(minBound.x, maxBound.y);
+
+	_lines.append(sf::Vertex(minBound, col));
+	_lines.append(sf::Vertex(topRight, col));
+	_lines.append(sf::Vertex(topRight, col));
+	_lines.append(sf::Vertex(maxBound, col));
+	_lines.append(sf::Vertex(maxBound, col));
+	_lines.append(sf::Vertex(bottomLeft, col));
+	_lines.append(sf::Vertex(bottomLeft, col));
+	_lines.append(sf::Vertex(minBound, col));
 }
 
-void SFMLApp::DrawPolygon(const std::vector<XMVECTOR>& vertices, const sf::Color& col) {
-	if (vertices.size() < 3) {
+void SFMLApp::AppendPolygon(const XMVECTOR* vertices, const std::size_t vertexCount, const sf::Vector2f position,
+	const sf::Vector2f scale, const sf::Color& col) noexcept {
+	if (vertexCount < 3) {
 		return;  // Don't draw if the polygon is invalid
 	}
 
-	sf::ConvexShape polygon(vertices.size());
+	const auto Transform = [position, scale](const XMVECTOR vertex) {
+		return sf::Vector2f(XMVectorGetX(vertex) * scale.x + position.x, XMVectorGetY(vertex) * scale.y + position.y);
+	};
 
-	for (size_t i = 0; i < vertices.size(); ++i) {
-		polygon.setPoint(i, sf::Vector2f(XMVectorGetX(vertices[i]), XMVectorGetY(vertices[i])));
+	// The polygons are convex, a fan from the first vertex covers them
+	const sf::Vector2f first = Transform(vertices[0]);
+	for (size_t i = 1; i + 1 < vertexCount; ++i) {
+		_triangles.append(sf::Vertex(first, col));
+		_triangles.append(sf::Vertex(Transform(vertices[i]), col));
+		_triangles.append(sf::Vertex(Transform(vertices[i + 1]), col));
 	}
-
-	polygon.setFillColor(col);
-
-	_window.draw(polygon);
 }
 
-void SFMLApp::DrawAllGraphicsData() noexcept {
+void SFMLApp::DrawAllGraphicsData(const RenderFrame& frame) noexcept {
 #ifdef TRACY_ENABLE
 	ZoneScoped;
 #endif
-	for (auto& bd : _sampleManager.GetSampleData()) {
-		if (bd.Shape.index() == (int)ShapeType::Circle) {
-			auto& circle = std::get<CircleF>(bd.Shape);
-			DrawCircle(circle.Center(), circle.Radius(), 30,
-				{ static_cast<sf::Uint8>(bd.Color.r),
-				 static_cast<sf::Uint8>(bd.Color.g),
-				 static_cast<sf::Uint8>(bd.Color.b),
-				 static_cast<sf::Uint8>(bd.Color.a) });
+	_triangles.clear();
+	_lines.clear();
+
+	const auto& shapes = frame.Shapes;
+
+	for (const auto& item : frame.Items) {
+		const sf::Color color(static_cast<sf::Uint8>(item.Color.r),
+			static_cast<sf::Uint8>(item.Color.g),
+			static_cast<sf::Uint8>(item.Color.b),
+			static_cast<sf::Uint8>(item.Color.a));
+		const sf::Vector2f position(item.X, item.Y);
+		const sf::Vector2f scale(item.ScaleX, item.ScaleY);
+		const auto& shape = shapes[item.ShapeIndex];
+
+		if (shape.index() == (int)ShapeType::Circle) {
+			auto& circle = std::get<CircleF>(shape);
+			const sf::Vector2f center(XMVectorGetX(circle.Center()) * scale.x + position.x,
+				XMVectorGetY(circle.Center()) * scale.y + position.y);
+			AppendCircle(center, scale * circle.Radius(), color);
 		}
-		else if (bd.Shape.index() == (int)ShapeType::Rectangle) {
-			auto& rect = std::get<RectangleF>(bd.Shape);
-			if (!bd.Filled) {
-				DrawRectangleBorder(rect.MinBound(), rect.MaxBound(),
-					{ static_cast<sf::Uint8>(bd.Color.r),
-					 static_cast<sf::Uint8>(bd.Color.g),
-					 static_cast<sf::Uint8>(bd.Color.b),
-					 static_cast<sf::Uint8>(bd.Color.a) });
+		else if (shape.index() == (int)ShapeType::Rectangle) {
+			auto& rect = std::get<RectangleF>(shape);
+			const sf::Vector2f minBound(XMVectorGetX(rect.MinBound()) * scale.x + position.x,
+				XMVectorGetY(rect.MinBound()) * scale.y + position.y);
+			const sf::Vector2f maxBound(XMVectorGetX(rect.MaxBound()) * scale.x + position.x,
+				XMVectorGetY(rect.MaxBound()) * scale.y + position.y);
+			if (!item.Filled) {
+				AppendRectangleBorder(minBound, maxBound, color);
 			}
 			else {
-				DrawRectangle(rect.MinBound(), rect.MaxBound(),
-					{ static_cast<sf::Uint8>(bd.Color.r),
-					 static_cast<sf::Uint8>(bd.Color.g),
-					 static_cast<sf::Uint8>(bd.Color.b),
-					 static_cast<sf::Uint8>(bd.Color.a) });
+				AppendRectangle(minBound, maxBound, color);
 			}
 		}
-		else if (bd.Shape.index() == (int)ShapeType::Polygon) {
-			auto& polygon = std::get<PolygonF>(bd.Shape);
-			DrawPolygon(polygon.Vertices(), { static_cast<sf::Uint8>(bd.Color.r),
-											 static_cast<sf::Uint8>(bd.Color.g),
-											 static_cast<sf::Uint8>(bd.Color.b),
-											 static_cast<sf::Uint8>(bd.Color.a) });
+		else if (shape.index() == (int)ShapeType::Polygon) {
+			auto& polygon = std::get<PolygonF>(shape);
+			AppendPolygon(polygon.Vertices().data(), polygon.Vertices().size(), position, scale, color);
+		}
+		else if (shape.index() == (int)ShapeType::OrientedRectangle) {
+			const auto corners = std::get<OrientedRectangleF>(shape).Corners();
+			AppendPolygon(corners.data(), corners.size(), position, scale, color);
 		}
 	}
+
+	// The borders stay visible over the filled shapes
+	_window.draw(_triangles);
+	_window.draw(_lines);
 }
@@ -13,7 +13,7 @@ static constexpr float SPEED = 500;
 class GroundCollisionSample : public Sample, public ContactListener
 {
 private:
-	
+	std::uint32_t _circleShape = 0; // Unit circle of the shape table, drawing every ball
 
 public:
 	std::string GetName() noexcept override;
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 
 #include "Metrics.h"
@@ -9,17 +10,22 @@
 struct Color {
   int r = 255, g = 255, b = 255, a = 255;
 };
-// for the graphics renderer to draw
-struct GraphicsData {
-  std::variant<CircleF, RectangleF, PolygonF> Shape{
-      CircleF(XMVectorZero(), 1)};
+// for the graphics renderer to draw, a shape of the shape table placed in the
+// scene, plain data so that a frame of items is copied as a block
+struct RenderItem {
+  float X = 0.f, Y = 0.f;            // Translation of the shape
+  float ScaleX = 1.f, ScaleY = 1.f;  // Scale of the shape, before the translation
+  std::uint32_t ShapeIndex = 0;      // Index of the shape in the shape table
   bool Filled = true;
   Color Color;
 };
 
 class Sample {
  public:
-  std::vector<GraphicsData> AllGraphicsData;
+  std::vector<RenderItem> RenderItems;
+  // Shapes drawn by the render items, only appended to and never modified so
+  // that every item sharing a shape reads the same one
+  std::vector<ColliderShape> RenderShapes;
 
  protected:
   World _world;
@@ -54,6 +60,18 @@ class Sample {
   virtual ~Sample() noexcept = default;
 
  protected:
+  /**
+   * @brief Add a shape to the shape table.
+   * @return The index of the shape, to be set in the render items drawing it.
+   */
+  std::uint32_t AddRenderShape(const ColliderShape& shape) noexcept;
+
+  /**
+   * @brief Move each render item to the interpolated position of the body of
+   * the same index.
+   */
+  void UpdateRenderPositions() noexcept;
+
   virtual void SampleSetUp() noexcept = 0;
 
   virtual void SampleTearDown() noexcept = 0;
@@ -14,9 +14,12 @@ private:
 
 	std::size_t _sampleIdx = 0;
 
+	std::uint64_t _sampleVersion = 0; // Incremented each time a sample is set up, its render shapes being rebuilt.
+
 public:
 	[[nodiscard]] int GetSampleNbr() noexcept { return _samples.size(); }
 	[[nodiscard]] int GetCurrentIndex() noexcept { return _sampleIdx; }
+	[[nodiscard]] std::uint64_t GetSampleVersion() const noexcept { return _sampleVersion; }
 
 	[[nodiscard]] std::string GetSampleName(int idx) { return _samples[idx]->GetName(); }
 	[[nodiscard]] std::string GetSampleDescription(int idx) { return _samples[idx]->GetDescription(); }
@@ -31,9 +34,11 @@ public:
 
 	void PreviousSample() noexcept;
 
-	void RegenerateSample() const noexcept;
+	void RegenerateSample() noexcept;
+
+	[[nodiscard]] const std::vector<RenderItem>& GetRenderItems() const noexcept;
 
-	[[nodiscard]] std::vector<GraphicsData>& GetSampleData() const noexcept;
+	[[nodiscard]] const std::vector<ColliderShape>& GetRenderShapes() const noexcept;
 
 	void GiveMousePositionToSample(XMVECTOR mousePosition) const noexcept;
 
@@ -2,15 +2,17 @@
 
 #include "Sample.h"
 #include "Random.h"
+#include "GravityTree.h"
 
 class StarSystemSample : public Sample
 {
 private:
-    std::vector<CircleF> _circles;
+    GravityTree _gravityTree;
 
     BodyRef _sunRef;
 
     static constexpr float G = 6.67f;
+    static constexpr float SOFTENING = 5.f;
     static constexpr std::size_t PLANET_NBR = 1000;
 public:
     std::string GetName() noexcept override;
@@ -22,7 +24,4 @@ protected:
 
     void SampleTearDown() noexcept override;
 
-private:
-    static void CalculateGravitationalForce(const Body &sun, Body &body) noexcept;
-
 };
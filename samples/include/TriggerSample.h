@@ -8,7 +8,7 @@
 class TriggerSample : public Sample, public ContactListener
 {
 private:
-	std::vector<GraphicsData> _quadTreeGraphicsData;
+	std::uint32_t _quadTreeShape = 0; // Unit square scaled to each leaf of the QuadTree
 	std::vector<int> _triggerNbrPerCollider;
 
 
@@ -47,6 +47,6 @@ protected:
 	void SampleTearDown() noexcept override;
 
 private:
-	void DrawQuadtree(const QuadNode& node) noexcept;
+	void DrawQuadtree(std::size_t nodeIndex) noexcept;
 
 };
\ No newline at end of file
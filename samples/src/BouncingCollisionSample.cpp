@@ -18,8 +18,8 @@ void BouncingCollisionSample::OnCollisionEnter(ColliderRef col1, ColliderRef col
 	Random::Range(0, 255),
 	Random::Range(0, 255),
 	255 };
-	AllGraphicsData[col1.Index].Color = color;
-	AllGraphicsData[col2.Index].Color = color;
+	RenderItems[col1.Index()].Color = color;
+	RenderItems[col2.Index()].Color = color;
 }
 
 void BouncingCollisionSample::OnCollisionExit(ColliderRef col1, ColliderRef col2) noexcept
@@ -30,12 +30,19 @@ void BouncingCollisionSample::OnCollisionExit(ColliderRef col1, ColliderRef col2
 void BouncingCollisionSample::SampleSetUp() noexcept
 {
 	_world.SetContactListener(this);
+	_world.SetBounds(RectangleF(XMVectorZero(), XMVectorSet(Metrics::Width, Metrics::Height, 0, 0)));
 	_nbObjects = CIRCLE_NBR + RECTANGLE_NBR;
 	_collisionNbrPerCollider.resize(_nbObjects, 0);
-	AllGraphicsData.reserve(_nbObjects);
+	RenderItems.reserve(_nbObjects);
+	_quadTreeShape = AddRenderShape(RectangleF(XMVectorZero(), XMVectorSet(1.f, 1.f, 0.f, 0.f)));
 	_bodyRefs.reserve(_nbObjects);
 	_colRefs.reserve(_nbObjects);
 
+	RenderItem circleItem;
+	circleItem.ShapeIndex = AddRenderShape(Circle(XMVectorZero(), CIRCLE_RADIUS));
+	RenderItem rectangleItem;
+	rectangleItem.ShapeIndex = AddRenderShape(RectangleF(XMVectorZero(), RECTANGLE_BOUNDS));
+
 	//Create Circles
 	for (std::size_t i = 0; i < CIRCLE_NBR; ++i)
 	{
@@ -57,9 +64,7 @@ void BouncingCollisionSample::SampleSetUp() noexcept
 		col1.Shape = Circle(XMVectorZero(), CIRCLE_RADIUS);
 		col1.BodyPosition = body1.Position;
 
-		GraphicsData bd;
-		bd.Shape = Circle(XMVectorZero(), CIRCLE_RADIUS) + body1.Position;
-		AllGraphicsData.push_back(bd);
+		RenderItems.push_back(circleItem);
 	}
 
 	//Create Rectangles
@@ -80,77 +85,44 @@ void BouncingCollisionSample::SampleSetUp() noexcept
 		col1.Shape = RectangleF(XMVectorZero(), RECTANGLE_BOUNDS);
 		col1.BodyPosition = body1.Position;
 
-		GraphicsData bd;
-		bd.Shape = RectangleF(XMVectorZero(), RECTANGLE_BOUNDS) + body1.Position;
-		AllGraphicsData.push_back(bd);
+		RenderItems.push_back(rectangleItem);
 	}
 }
 
-void BouncingCollisionSample::DrawQuadtree(const QuadNode& node) noexcept
+void BouncingCollisionSample::DrawQuadtree(const std::size_t nodeIndex) noexcept
 {
-	if (node.Children[0] == nullptr)
+	const auto& node = _world.QuadTree.Nodes[nodeIndex];
+	if (node.IsLeaf)
 	{
-		_quadTreeGraphicsData.push_back({ RectangleF(node.Bounds), false });
+		RenderItem item;
+		item.X = XMVectorGetX(node.Bounds.MinBound());
+		item.Y = XMVectorGetY(node.Bounds.MinBound());
+		item.ScaleX = XMVectorGetX(node.Bounds.Size());
+		item.ScaleY = XMVectorGetY(node.Bounds.Size());
+		item.ShapeIndex = _quadTreeShape;
+		item.Filled = false;
+		RenderItems.push_back(item);
 	}
 	else
 	{
-		for (int i = 0; i < 4; i++)
+		const std::size_t firstChild = QuadTree::FirstChild(nodeIndex);
+		for (std::size_t i = firstChild; i < firstChild + 4; i++)
 		{
-			DrawQuadtree(*node.Children[i]);
+			DrawQuadtree(i);
 		}
 	}
 }
 
 void BouncingCollisionSample::SampleUpdate() noexcept
 {
-	if (_nbObjects < AllGraphicsData.size())
-	{
-		AllGraphicsData.erase(AllGraphicsData.begin() + _nbObjects, AllGraphicsData.end());
-	}
-
-	for (std::size_t i = 0; i < _colRefs.size(); ++i)
-	{
-		auto& col = _world.GetCollider(_colRefs[i]);
-		auto bounds = col.GetBounds();
-		auto& body = _world.GetBody(col.BodyRef);
-
-		if (XMVectorGetX(bounds.MinBound()) <= 0)
-		{
-			body.Velocity = XMVectorSetX(body.Velocity, Abs(XMVectorGetX(body.Velocity)));
-		}
-		else if (XMVectorGetX(bounds.MaxBound()) >= Metrics::Width)
-		{
-			body.Velocity = XMVectorSetX(body.Velocity, -Abs(XMVectorGetX(body.Velocity)));
-		}
-		if (XMVectorGetY(bounds.MinBound()) <= 0)
-		{
-			body.Velocity = XMVectorSetY(body.Velocity, Abs(XMVectorGetY(body.Velocity)));
-		}
-		else if (XMVectorGetY(bounds.MaxBound()) >= Metrics::Height)
-		{
-			body.Velocity = XMVectorSetY(body.Velocity, -Abs(XMVectorGetY(body.Velocity)));
-		}
-
-		auto& shape = _world.GetCollider(_colRefs[i]).Shape;
-
-		switch (shape.index())
-		{
-		case static_cast<int>(ShapeType::Circle):
-			AllGraphicsData[i].Shape = std::get<CircleF>(shape) + col.BodyPosition;
-			break;
-		case static_cast<int>(ShapeType::Rectangle):
-			AllGraphicsData[i].Shape = std::get<RectangleF>(shape) + col.BodyPosition;
-			break;
-		}
-	}
+	// The QuadTree leaves of the previous frame follow the objects
+	RenderItems.resize(_nbObjects);
 
-	_quadTreeGraphicsData.clear();
-	DrawQuadtree(_world.QuadTree.Nodes[0]);
-	AllGraphicsData.insert(AllGraphicsData.end(), _quadTreeGraphicsData.begin(), _quadTreeGraphicsData.end());
+	UpdateRenderPositions();
+	DrawQuadtree(0);
 }
 
 void BouncingCollisionSample::SampleTearDown() noexcept
 {
 	_collisionNbrPerCollider.clear();
-	_quadTreeGraphicsData.clear();
 }
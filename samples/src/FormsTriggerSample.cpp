@@ -12,21 +12,21 @@ std::string FormsTriggerSample::GetDescription() noexcept
 
 void FormsTriggerSample::OnTriggerEnter(ColliderRef col1, ColliderRef col2) noexcept
 {
-	_triggerNbrPerCollider[col1.Index]++;
-	_triggerNbrPerCollider[col2.Index]++;
+	_triggerNbrPerCollider[col1.Index()]++;
+	_triggerNbrPerCollider[col2.Index()]++;
 }
 
 void FormsTriggerSample::OnTriggerExit(ColliderRef col1, ColliderRef col2) noexcept
 {
-	_triggerNbrPerCollider[col1.Index]--;
-	_triggerNbrPerCollider[col2.Index]--;
+	_triggerNbrPerCollider[col1.Index()]--;
+	_triggerNbrPerCollider[col2.Index()]--;
 }
 
 void FormsTriggerSample::SampleSetUp() noexcept
 {
 	_world.SetContactListener(this);
 
-	_triggerNbrPerCollider.resize(4, 0);
+	_triggerNbrPerCollider.resize(5, 0);
 
 	auto triangleRef = _world.CreateBody();
 	auto& triangle = _world.GetBody(triangleRef);
@@ -46,9 +46,9 @@ void FormsTriggerSample::SampleSetUp() noexcept
 	triangleCol.Shape = PolygonF(verticesTriangle);
 	triangleCol.IsTrigger = true;
 
-	GraphicsData gdTriangle;
-	gdTriangle.Shape = PolygonF(verticesTriangle) + triangle.Position;
-	AllGraphicsData.push_back(gdTriangle);
+	RenderItem triangleItem;
+	triangleItem.ShapeIndex = AddRenderShape(PolygonF(verticesTriangle));
+	RenderItems.push_back(triangleItem);
 
 
 	_movableTriangleRef = _world.CreateBody();
@@ -69,9 +69,9 @@ void FormsTriggerSample::SampleSetUp() noexcept
 	movableTriangleCol.Shape = PolygonF(verticesMovableTriangle);
 	movableTriangleCol.IsTrigger = true;
 
-	GraphicsData gdMovableTriangle;
-	gdMovableTriangle.Shape = PolygonF(verticesMovableTriangle) + movableTriangleBody.Position;
-	AllGraphicsData.push_back(gdMovableTriangle);
+	RenderItem movableTriangleItem;
+	movableTriangleItem.ShapeIndex = AddRenderShape(PolygonF(verticesMovableTriangle));
+	RenderItems.push_back(movableTriangleItem);
 
 
 	auto circleBodyRef = _world.CreateBody();
@@ -84,9 +84,9 @@ void FormsTriggerSample::SampleSetUp() noexcept
 	circleCol.Shape = Circle(XMVectorZero(), Metrics::MetersToPixels(0.3f));
 	circleCol.IsTrigger = true;
 
-	GraphicsData gdCircle;
-	gdCircle.Shape = Circle(XMVectorZero(), Metrics::MetersToPixels(0.3f)) + circleBody.Position;
-	AllGraphicsData.push_back(gdCircle);
+	RenderItem circleItem;
+	circleItem.ShapeIndex = AddRenderShape(Circle(XMVectorZero(), Metrics::MetersToPixels(0.3f)));
+	RenderItems.push_back(circleItem);
 
 	auto rectRef = _world.CreateBody();
 	auto& rect = _world.GetBody(rectRef);
@@ -104,12 +104,31 @@ void FormsTriggerSample::SampleSetUp() noexcept
 			Metrics::MetersToPixels(2), 0, 0));
 	colRect.IsTrigger = true;
 
-	GraphicsData gdRect;
-	gdRect.Shape = RectangleF(XMVectorZero(),
+	RenderItem rectItem;
+	rectItem.ShapeIndex = AddRenderShape(RectangleF(XMVectorZero(),
 		XMVectorSet(
 			Metrics::MetersToPixels(2),
-			Metrics::MetersToPixels(2), 0, 0)) + rect.Position;
-	AllGraphicsData.push_back(gdRect);
+			Metrics::MetersToPixels(2), 0, 0)));
+	RenderItems.push_back(rectItem);
+
+	auto crateRef = _world.CreateBody();
+	auto& crate = _world.GetBody(crateRef);
+	crate.Position = XMVectorSet(Metrics::MetersToPixels(5), Metrics::MetersToPixels(6), 0, 0);
+
+	_bodyRefs.push_back(crateRef);
+
+	auto colRefCrate = _world.CreateCollider(crateRef);
+	_colRefs.push_back(colRefCrate);
+	auto& colCrate = _world.GetCollider(colRefCrate);
+
+	const OrientedRectangleF crateShape(XMVectorZero(),
+		XMVectorSet(Metrics::MetersToPixels(1), Metrics::MetersToPixels(0.5f), 0, 0), XM_PI / 6.f);
+	colCrate.Shape = crateShape;
+	colCrate.IsTrigger = true;
+
+	RenderItem crateItem;
+	crateItem.ShapeIndex = AddRenderShape(crateShape);
+	RenderItems.push_back(crateItem);
 }
 
 void FormsTriggerSample::SampleUpdate() noexcept
@@ -117,16 +136,16 @@ void FormsTriggerSample::SampleUpdate() noexcept
 	auto& movableTriangleBody = _world.GetBody(_movableTriangleRef);
 	movableTriangleBody.Position = _mousePos;
 
-	AllGraphicsData[1].Shape = std::get<PolygonF>(_world.GetCollider(_colRefs[1]).Shape) + movableTriangleBody.Position;
+	UpdateRenderPositions();
 	for (int i = 0; i < _colRefs.size(); ++i)
 	{
 		if (_triggerNbrPerCollider[i] > 0)
 		{
-			AllGraphicsData[i].Color = { 0, 255, 0, 255 };
+			RenderItems[i].Color = { 0, 255, 0, 255 };
 		}
 		else
 		{
-			AllGraphicsData[i].Color = { 0, 0, 255, 255 };
+			RenderItems[i].Color = { 0, 0, 255, 255 };
 		}
 	}
 }
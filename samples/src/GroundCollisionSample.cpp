@@ -18,6 +18,10 @@ void GroundCollisionSample::OnCollisionExit(ColliderRef col1,
 
 void GroundCollisionSample::SampleSetUp() noexcept {
   _world.SetContactListener(this);
+  _world.SetSleepingEnabled(true);
+  _world.SetGravity(XMVectorSet(0, SPEED, 0, 0));
+  // The ground spans most leaves of a tight tree, a loose one stores it once
+  _world.SetLooseQuadTree(true);
 
   // Create static rectangle
   const auto groundRef = _world.CreateBody();
@@ -42,7 +46,12 @@ void GroundCollisionSample::SampleSetUp() noexcept {
   groundCol.BodyPosition = groundBody.Position;
   groundCol.Restitution = 1.f;
 
-  AllGraphicsData.emplace_back();
+  RenderItem groundItem;
+  groundItem.ShapeIndex = AddRenderShape(groundCol.Shape);
+  RenderItems.push_back(groundItem);
+
+  // Every ball has its own radius, the unit circle is scaled to it
+  _circleShape = AddRenderShape(CircleF(XMVectorZero(), 1.f));
 }
 void GroundCollisionSample::SampleUpdate() noexcept {
   if (_mouseLeftReleased) {
@@ -51,28 +60,7 @@ void GroundCollisionSample::SampleUpdate() noexcept {
     CreateRect(_mousePos);
   }
 
-  for (std::size_t i = 0; i < _colRefs.size(); ++i) {
-    const auto& col = _world.GetCollider(_colRefs[i]);
-
-    const auto& shape = _world.GetCollider(_colRefs[i]).Shape;
-
-    switch (shape.index()) {
-      case static_cast<int>(ShapeType::Circle):
-        _world.GetBody(col.BodyRef).ApplyForce({0, SPEED});
-        AllGraphicsData[i].Shape =
-            std::get<CircleF>(shape) + col.BodyPosition;
-        break;
-      case static_cast<int>(ShapeType::Rectangle):
-        if (i != 0) {
-          _world.GetBody(col.BodyRef).ApplyForce({0, SPEED});
-        }
-        AllGraphicsData[i].Shape =
-            std::get<RectangleF>(shape) + col.BodyPosition;
-        break;
-      default:
-        break;
-    }
-  }
+  UpdateRenderPositions();
 }
 
 void GroundCollisionSample::SampleTearDown() noexcept {}
@@ -85,6 +73,7 @@ void GroundCollisionSample::CreateBall(XMVECTOR position) noexcept {
   circleBody.Mass = 1;
 
   circleBody.Position = position;
+  circleBody.PreviousPosition = position;
 
   const auto circleColRef = _world.CreateCollider(circleBodyRef);
   _colRefs.push_back(circleColRef);
@@ -94,11 +83,15 @@ void GroundCollisionSample::CreateBall(XMVECTOR position) noexcept {
   circleCol.BodyPosition = circleBody.Position;
   circleCol.Restitution = 0.f;
 
-  GraphicsData gd;
-  gd.Color = {Random::Range(0, 255), Random::Range(0, 255),
-              Random::Range(0, 255), 255};
+  RenderItem item;
+  item.ShapeIndex = _circleShape;
+  item.ScaleX = item.ScaleY = std::get<CircleF>(circleCol.Shape).Radius();
+  item.X = XMVectorGetX(position);
+  item.Y = XMVectorGetY(position);
+  item.Color = {Random::Range(0, 255), Random::Range(0, 255),
+                Random::Range(0, 255), 255};
 
-  AllGraphicsData.emplace_back(gd);
+  RenderItems.push_back(item);
 }
 
 void GroundCollisionSample::CreateRect(XMVECTOR position) noexcept {
@@ -108,6 +101,7 @@ void GroundCollisionSample::CreateRect(XMVECTOR position) noexcept {
   rectBody.Type = BodyType::DYNAMIC;
 
   rectBody.Position = {position};
+  rectBody.PreviousPosition = position;
 
   const auto rectColRef = _world.CreateCollider(rectBodyRef);
   _colRefs.push_back(rectColRef);
@@ -119,9 +113,12 @@ void GroundCollisionSample::CreateRect(XMVECTOR position) noexcept {
   rectCol.BodyPosition = rectBody.Position;
   rectCol.Restitution = 0.f;
 
-  GraphicsData gd;
-  gd.Color = {Random::Range(0, 255), Random::Range(0, 255),
-              Random::Range(0, 255), 255};
+  RenderItem item;
+  item.ShapeIndex = AddRenderShape(rectCol.Shape);
+  item.X = XMVectorGetX(position);
+  item.Y = XMVectorGetY(position);
+  item.Color = {Random::Range(0, 255), Random::Range(0, 255),
+                Random::Range(0, 255), 255};
 
-  AllGraphicsData.emplace_back(gd);
+  RenderItems.push_back(item);
 }
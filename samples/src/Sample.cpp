@@ -5,13 +5,14 @@ void Sample::SetUp() noexcept
     _timer.SetUp();
     _world.SetUp();
     SampleSetUp();
+    _world.ResetInterpolation();
 }
 
 void Sample::Update() noexcept
 {
     SampleUpdate();
     _timer.Tick();
-    _world.Update(_timer.DeltaTime);
+    _world.FixedUpdate(_timer.DeltaTime);
     _mouseLeftReleased = false;
     _mouseRightReleased = false;
 }
@@ -20,11 +21,28 @@ void Sample::TearDown() noexcept
 {
     SampleTearDown();
     _bodyRefs.clear();
-    AllGraphicsData.clear();
+    RenderItems.clear();
+    RenderShapes.clear();
     _colRefs.clear();
     _world.TearDown();
 }
 
+std::uint32_t Sample::AddRenderShape(const ColliderShape& shape) noexcept
+{
+    RenderShapes.push_back(shape);
+    return static_cast<std::uint32_t>(RenderShapes.size() - 1);
+}
+
+void Sample::UpdateRenderPositions() noexcept
+{
+    for (std::size_t i = 0; i < _bodyRefs.size(); ++i)
+    {
+        const auto position = _world.GetInterpolatedPosition(_bodyRefs[i]);
+        RenderItems[i].X = XMVectorGetX(position);
+        RenderItems[i].Y = XMVectorGetY(position);
+    }
+}
+
 void Sample::GetMousePos(const XMVECTOR mousePos) noexcept
 {
     _mousePos = mousePos;
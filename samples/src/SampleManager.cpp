@@ -10,6 +10,7 @@ void SampleManager::SetUp() noexcept
     _samples.push_back(std::make_unique<GroundCollisionSample>());
 
     _samples[_sampleIdx]->SetUp();
+    _sampleVersion++;
 }
 
 void SampleManager::UpdateSample() const noexcept
@@ -22,6 +23,7 @@ void SampleManager::ChangeSample(int idx) noexcept
     _samples[_sampleIdx]->TearDown();
     _sampleIdx = idx;
     _samples[_sampleIdx]->SetUp();
+    _sampleVersion++;
 }
 
 void SampleManager::NextSample() noexcept
@@ -32,6 +34,7 @@ void SampleManager::NextSample() noexcept
     else
         _sampleIdx++;
     _samples[_sampleIdx]->SetUp();
+    _sampleVersion++;
 }
 
 void SampleManager::PreviousSample() noexcept
@@ -42,17 +45,24 @@ void SampleManager::PreviousSample() noexcept
     else
         _sampleIdx--;
     _samples[_sampleIdx]->SetUp();
+    _sampleVersion++;
 }
 
-void SampleManager::RegenerateSample() const noexcept
+void SampleManager::RegenerateSample() noexcept
 {
     _samples[_sampleIdx]->TearDown();
     _samples[_sampleIdx]->SetUp();
+    _sampleVersion++;
 }
 
-std::vector<GraphicsData> &SampleManager::GetSampleData() const noexcept
+const std::vector<RenderItem>& SampleManager::GetRenderItems() const noexcept
 {
-    return _samples[_sampleIdx]->AllGraphicsData;
+    return _samples[_sampleIdx]->RenderItems;
+}
+
+const std::vector<ColliderShape>& SampleManager::GetRenderShapes() const noexcept
+{
+    return _samples[_sampleIdx]->RenderShapes;
 }
 
 void SampleManager::GiveMousePositionToSample(const XMVECTOR mousePosition) const noexcept
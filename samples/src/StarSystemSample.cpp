@@ -7,11 +7,14 @@ std::string StarSystemSample::GetName() noexcept
 
 std::string StarSystemSample::GetDescription() noexcept
 {
-	return "Randomly generated physical objects rotating around a \"sun\" using forces.";
+	return "Randomly generated physical objects rotating around a \"sun\", every body attracting the others through a Barnes-Hut gravity tree.";
 }
 
 void StarSystemSample::SampleSetUp() noexcept
 {
+	_gravityTree.SetGravitationalConstant(G);
+	_gravityTree.SetSoftening(SOFTENING);
+
 	{
 		_sunRef = _world.CreateBody();
 		auto& sun = _world.GetBody(_sunRef);
@@ -19,10 +22,12 @@ void StarSystemSample::SampleSetUp() noexcept
 		sun.Mass = 1000000;
 
 		_bodyRefs.push_back(_sunRef);
-		GraphicsData sgd;
-		_circles.emplace_back(XMVectorZero(), Metrics::MetersToPixels(0.03f));
-		sgd.Color = { 255, 255, 0, 255 };
-		AllGraphicsData.push_back(sgd);
+		// Every body is the unit circle scaled to its radius
+		RenderItem sunItem;
+		sunItem.ShapeIndex = AddRenderShape(CircleF(XMVectorZero(), 1.f));
+		sunItem.ScaleX = sunItem.ScaleY = Metrics::MetersToPixels(0.03f);
+		sunItem.Color = { 255, 255, 0, 255 };
+		RenderItems.push_back(sunItem);
 
 		for (std::size_t i = 0; i < PLANET_NBR; ++i)
 		{
@@ -39,55 +44,30 @@ void StarSystemSample::SampleSetUp() noexcept
 
 			// Graphics
 			_bodyRefs.push_back(bodyRef);
-			GraphicsData gd;
-			_circles.emplace_back(XMVectorZero(),
-				Random::Range(
-					Metrics::MetersToPixels(0.05f),
-					Metrics::MetersToPixels(0.15f)));
-			gd.Color = {
+			RenderItem item;
+			item.ShapeIndex = sunItem.ShapeIndex;
+			item.ScaleX = item.ScaleY = Random::Range(
+				Metrics::MetersToPixels(0.05f),
+				Metrics::MetersToPixels(0.15f));
+			item.Color = {
 					Random::Range(0, 255),
 					Random::Range(0, 255),
 					Random::Range(0, 255),
 					255 };
 
-			AllGraphicsData.push_back(gd);
+			RenderItems.push_back(item);
 		}
 	}
 }
 
-void StarSystemSample::CalculateGravitationalForce(const Body& sun, Body& body) noexcept
-{
-
-	auto m1m2 = sun.Mass * body.Mass;
-	auto r = XMVectorGetX(XMVector3Length(XMVectorSubtract(sun.Position, body.Position)));
-	auto r2 = r * r;
-	auto F = G * (m1m2 / r2);
-
-	XMVECTOR forceDirection = XMVector3Normalize(XMVectorSubtract(sun.Position, body.Position));
-	XMVECTOR force = XMVectorScale(forceDirection, F);
-	body.ApplyForce(force);
-
-}
-
 void StarSystemSample::SampleUpdate() noexcept
 {
-	auto& sun = _world.GetBody(_sunRef);
+	_gravityTree.ApplyForces(_world.GetBodies());
 
-	for (std::size_t i = 0; i < _bodyRefs.size(); ++i)
-	{
-		auto& body = _world.GetBody(_bodyRefs[i]);
-
-		AllGraphicsData[i].Shape = _circles[i] + body.Position;
-
-		if (_bodyRefs[i] == _sunRef) continue; // Skip the Sun
-
-		CalculateGravitationalForce(sun, body);
-
-	}
+	UpdateRenderPositions();
 }
 
 void StarSystemSample::SampleTearDown() noexcept
 {
-	_circles.clear();
 }
 
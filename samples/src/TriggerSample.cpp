@@ -12,25 +12,34 @@ std::string TriggerSample::GetDescription() noexcept
 
 void TriggerSample::OnTriggerEnter(ColliderRef col1, ColliderRef col2) noexcept
 {
-	_triggerNbrPerCollider[col1.Index]++;
-	_triggerNbrPerCollider[col2.Index]++;
+	_triggerNbrPerCollider[col1.Index()]++;
+	_triggerNbrPerCollider[col2.Index()]++;
 }
 
 void TriggerSample::OnTriggerExit(ColliderRef col1, ColliderRef col2) noexcept
 {
-	_triggerNbrPerCollider[col1.Index]--;
-	_triggerNbrPerCollider[col2.Index]--;
+	_triggerNbrPerCollider[col1.Index()]--;
+	_triggerNbrPerCollider[col2.Index()]--;
 }
 
 void TriggerSample::SampleSetUp() noexcept
 {
 	_world.SetContactListener(this);
+	_world.SetBounds(RectangleF(XMVectorZero(), XMVectorSet(Metrics::Width, Metrics::Height, 0, 0)));
 	_nbObjects = CIRCLE_NBR + RECTANGLE_NBR + TRIANGLE_NBR;
 	_triggerNbrPerCollider.resize(_nbObjects, 0);
-	AllGraphicsData.reserve(_nbObjects);
+	RenderItems.reserve(_nbObjects);
+	_quadTreeShape = AddRenderShape(RectangleF(XMVectorZero(), XMVectorSet(1.f, 1.f, 0.f, 0.f)));
 	_bodyRefs.reserve(_nbObjects);
 	_colRefs.reserve(_nbObjects);
 
+	RenderItem circleItem;
+	circleItem.ShapeIndex = AddRenderShape(Circle(XMVectorZero(), CIRCLE_RADIUS));
+	RenderItem rectangleItem;
+	rectangleItem.ShapeIndex = AddRenderShape(RectangleF(XMVectorZero(), RECTANGLE_BOUNDS));
+	RenderItem triangleItem;
+	triangleItem.ShapeIndex = AddRenderShape(PolygonF(TRIANGLE_VERTICES));
+
 	//Create Circles
 	for (std::size_t i = 0; i < CIRCLE_NBR; ++i)
 	{
@@ -50,9 +59,7 @@ void TriggerSample::SampleSetUp() noexcept
 		circleCol.BodyPosition = circleBody.Position;
 		circleCol.IsTrigger = true;
 
-		GraphicsData cgd;
-		cgd.Shape = Circle(XMVectorZero(), CIRCLE_RADIUS) + circleBody.Position;
-		AllGraphicsData.push_back(cgd);
+		RenderItems.push_back(circleItem);
 	}
 
 	//Create Rectangles
@@ -74,9 +81,7 @@ void TriggerSample::SampleSetUp() noexcept
 		rectCol.BodyPosition = rectBody.Position;
 		rectCol.IsTrigger = true;
 
-		GraphicsData rbd;
-		rbd.Shape = RectangleF(XMVectorZero(), RECTANGLE_BOUNDS) + rectBody.Position;
-		AllGraphicsData.push_back(rbd);
+		RenderItems.push_back(rectangleItem);
 	}
 	// Create Triangles
 	for (std::size_t i = 0; i < TRIANGLE_NBR; ++i)
@@ -97,89 +102,56 @@ void TriggerSample::SampleSetUp() noexcept
 		triangleCol.BodyPosition = triangleBody.Position;
 		triangleCol.IsTrigger = true;
 
-		GraphicsData tbd;
-		tbd.Shape = PolygonF(TRIANGLE_VERTICES) + triangleBody.Position;
-		AllGraphicsData.push_back(tbd);
+		RenderItems.push_back(triangleItem);
 	}
 }
 
-void TriggerSample::DrawQuadtree(const QuadNode& node) noexcept
+void TriggerSample::DrawQuadtree(const std::size_t nodeIndex) noexcept
 {
-	if (node.Children[0] == nullptr)
+	const auto& node = _world.QuadTree.Nodes[nodeIndex];
+	if (node.IsLeaf)
 	{
-		_quadTreeGraphicsData.push_back({ RectangleF(node.Bounds), false });
+		RenderItem item;
+		item.X = XMVectorGetX(node.Bounds.MinBound());
+		item.Y = XMVectorGetY(node.Bounds.MinBound());
+		item.ScaleX = XMVectorGetX(node.Bounds.Size());
+		item.ScaleY = XMVectorGetY(node.Bounds.Size());
+		item.ShapeIndex = _quadTreeShape;
+		item.Filled = false;
+		RenderItems.push_back(item);
 	}
 	else
 	{
-		for (int i = 0; i < 4; i++)
+		const std::size_t firstChild = QuadTree::FirstChild(nodeIndex);
+		for (std::size_t i = firstChild; i < firstChild + 4; i++)
 		{
-			DrawQuadtree(*node.Children[i]);
+			DrawQuadtree(i);
 		}
 	}
 }
 
 void TriggerSample::SampleUpdate() noexcept
 {
-	if (_nbObjects < AllGraphicsData.size())
-	{
-		AllGraphicsData.erase(AllGraphicsData.begin() + _nbObjects, AllGraphicsData.end());
-	}
+	// The QuadTree leaves of the previous frame follow the objects
+	RenderItems.resize(_nbObjects);
 
 	for (std::size_t i = 0; i < _colRefs.size(); ++i)
 	{
-		auto& col = _world.GetCollider(_colRefs[i]);
-		auto bounds = col.GetBounds();
-		auto& body = _world.GetBody(col.BodyRef);
-
-		if (XMVectorGetX(bounds.MinBound()) <= 0)
-		{
-			body.Velocity = XMVectorSetX(body.Velocity, Abs(XMVectorGetX(body.Velocity)));
-		}
-		else if (XMVectorGetX(bounds.MaxBound()) >= Metrics::Width)
-		{
-			body.Velocity = XMVectorSetX(body.Velocity, -Abs(XMVectorGetX(body.Velocity)));
-		}
-		if (XMVectorGetY(bounds.MinBound()) <= 0)
-		{
-			body.Velocity = XMVectorSetY(body.Velocity, Abs(XMVectorGetY(body.Velocity)));
-		}
-		else if (XMVectorGetY(bounds.MaxBound()) >= Metrics::Height)
-		{
-			body.Velocity = XMVectorSetY(body.Velocity, -Abs(XMVectorGetY(body.Velocity)));
-		}
-
-		auto& shape = _world.GetCollider(_colRefs[i]).Shape;
-
-		switch (shape.index())
-		{
-		case static_cast<int>(ShapeType::Circle):
-			AllGraphicsData[i].Shape = std::get<CircleF>(shape) + body.Position;
-			break;
-		case static_cast<int>(ShapeType::Rectangle):
-			AllGraphicsData[i].Shape = std::get<RectangleF>(shape) + body.Position;
-			break;
-		case static_cast<int>(ShapeType::Polygon):
-			AllGraphicsData[i].Shape = std::get<PolygonF>(shape) + body.Position;
-			break;
-		}
-
 		if (_triggerNbrPerCollider[i] > 0)
 		{
-			AllGraphicsData[i].Color = { 0, 255, 0, 255 };
+			RenderItems[i].Color = { 0, 255, 0, 255 };
 		}
 		else
 		{
-			AllGraphicsData[i].Color = { 0, 0, 255, 255 };
+			RenderItems[i].Color = { 0, 0, 255, 255 };
 		}
 	}
 
-	_quadTreeGraphicsData.clear();
-	DrawQuadtree(_world.QuadTree.Nodes[0]);
-	AllGraphicsData.insert(AllGraphicsData.end(), _quadTreeGraphicsData.begin(), _quadTreeGraphicsData.end());
+	UpdateRenderPositions();
+	DrawQuadtree(0);
 }
 
 void TriggerSample::SampleTearDown() noexcept
 {
 	_triggerNbrPerCollider.clear();
-	_quadTreeGraphicsData.clear();
 }